@@ -2,70 +2,232 @@
 #include <vector>
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+#include <new>
 
+// Move k elements between two circular buffers, starting at physical slots
+// sp and dp.  The ranges are split at both wrap points, so this is at most
+// three contiguous copies (memcpy for trivially copyable T).
 template<typename T>
+void ringMove(T* src, int srcCap, int sp, T* dst, int dstCap, int dp, int k) {
+    while (k > 0) {
+        int run = std::min(k, std::min(srcCap - sp, dstCap - dp));
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::memcpy(dst + dp, src + sp, run * sizeof(T));
+        } else {
+            std::move(src + sp, src + sp + run, dst + dp);
+        }
+        sp = (sp + run) % srcCap;
+        dp = (dp + run) % dstCap;
+        k -= run;
+    }
+}
+
+// Move n elements from src into raw storage at dst and end the source
+// objects' lifetimes; a single memcpy when T is trivially copyable
+template<typename T>
+void relocate(T* src, int n, T* dst) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (n > 0) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+    } else {
+        for (int i = 0; i < n; i++) {
+            ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+// ringMove for raw storage: the destination slots are unconstructed and
+// the source slots are left unconstructed
+template<typename T>
+void ringRelocate(T* src, int srcCap, int sp, T* dst, int dstCap, int dp, int k) {
+    while (k > 0) {
+        int run = std::min(k, std::min(srcCap - sp, dstCap - dp));
+        relocate(src + sp, run, dst + dp);
+        sp = (sp + run) % srcCap;
+        dp = (dp + run) % dstCap;
+        k -= run;
+    }
+}
+
+// Smallest power of two >= x
+constexpr int ceilPow2(int x) {
+    int p = 1;
+    while (p < x) p *= 2;
+    return p;
+}
+
+// Shift k elements inside one power-of-two circular buffer by d slots
+// (|d| < capacity), starting at physical slot from.  Like ringMove the runs
+// are cut at wrap points, so a one-slot shift is at most three contiguous
+// moves (memmove for trivially copyable T); moving up goes back to front
+// and moving down front to back, so the overlap is safe.
+template<typename T>
+void ringShift(T* a, int mask, int from, int k, int d) {
+    int cap = mask + 1;
+    if (d > 0) {
+        int se = (from + k) & mask;       // one past the last source slot
+        int de = (from + k + d) & mask;
+        while (k > 0) {
+            int sEnd = se == 0 ? cap : se;
+            int dEnd = de == 0 ? cap : de;
+            int run = std::min(k, std::min(sEnd, dEnd));
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                std::memmove(a + dEnd - run, a + sEnd - run, run * sizeof(T));
+            } else {
+                std::move_backward(a + sEnd - run, a + sEnd, a + dEnd);
+            }
+            se = (sEnd - run) & mask;
+            de = (dEnd - run) & mask;
+            k -= run;
+        }
+    } else {
+        int s = from & mask;
+        int t = (from + d) & mask;
+        while (k > 0) {
+            int run = std::min(k, std::min(cap - s, cap - t));
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                std::memmove(a + t, a + s, run * sizeof(T));
+            } else {
+                std::move(a + s, a + s + run, a + t);
+            }
+            s = (s + run) & mask;
+            t = (t + run) & mask;
+            k -= run;
+        }
+    }
+}
+
+// Circular deque over raw slots from Alloc: only the n elements from j
+// on are constructed, every other slot is unconstructed storage.
+template<typename T, typename Alloc = std::allocator<T>>
 class ArrayDeque {
 protected:
-    std::vector<T> a;  // backing array
+    using Traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc;
+    T* a;              // backing array of cap slots
+    int cap;           // a power of two
+    int mask;          // cap - 1
     int n;             // number of elements
     int j;             // index of first element
 
-    virtual void resize() {
-        std::vector<T> b(std::max(1, 2 * n));
-        for (int k = 0; k < n; k++) {
-            b[k] = a[(j + k) % a.size()];
-        }
+    template<typename... Args>
+    void construct(T* p, Args&&... args) {
+        Traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    // Move the elements to the front of a fresh array of newCap slots
+    void reallocate(int newCap) {
+        T* b = Traits::allocate(alloc, newCap);
+        int first = std::min(n, cap - j);
+        relocate(a + j, first, b);
+        relocate(a, n - first, b + first);
+        Traits::deallocate(alloc, a, cap);
         a = b;
+        cap = newCap;
+        mask = cap - 1;
         j = 0;
     }
 
-public:
-    ArrayDeque() : n(0), j(0) {
-        a.resize(1);
+    virtual void resize() {
+        reallocate(ceilPow2(std::max(1, 2 * n)));
     }
 
-    virtual ~ArrayDeque() {}
+    ArrayDeque(int capacity, const Alloc& alloc)
+      : alloc(alloc), a(Traits::allocate(this->alloc, capacity)), cap(capacity),
+        mask(capacity - 1), n(0), j(0) {}
+
+public:
+    ArrayDeque(const Alloc& alloc = Alloc()) : ArrayDeque(1, alloc) {}
+
+    // blocks are owned by their node and never copied
+    ArrayDeque(const ArrayDeque&) = delete;
+    ArrayDeque& operator=(const ArrayDeque&) = delete;
+
+    virtual ~ArrayDeque() {
+        clear();
+        Traits::deallocate(alloc, a, cap);
+    }
 
     int size() const {
         return n;
     }
 
+    int capacity() const {
+        return cap;
+    }
+
+    Alloc get_allocator() const {
+        return alloc;
+    }
+
+    // Destroy all elements but keep the backing array
+    void clear() {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (int i = 0; i < n; i++) a[(j + i) & mask].~T();
+        }
+        n = 0;
+        j = 0;
+    }
+
     T get(int i) const {
         if (i < 0 || i >= n) {
             throw std::out_of_range("Index out of range");
         }
-        return a[(j + i) % a.size()];
+        return a[(j + i) & mask];
     }
 
-    T set(int i, const T& x) {
+    // Unchecked element access, used by SEList iterators
+    T& operator[](int i) {
+        return a[(j + i) & mask];
+    }
+
+    const T& operator[](int i) const {
+        return a[(j + i) & mask];
+    }
+
+    T set(int i, T x) {
         if (i < 0 || i >= n) {
             throw std::out_of_range("Index out of range");
         }
-        T y = a[(j + i) % a.size()];
-        a[(j + i) % a.size()] = x;
+        T y = std::move(a[(j + i) & mask]);
+        a[(j + i) & mask] = std::move(x);
         return y;
     }
 
-    virtual void add(int i, const T& x) {
+    virtual void add(int i, T x) {
         if (i < 0 || i > n) {
             throw std::out_of_range("Invalid add position");
         }
-        if (n + 1 > a.size()) {
+        if (n + 1 > cap) {
             resize();
         }
-        if (i < n / 2) {
+        // the slot a shift moves into is raw: that one element is
+        // move-constructed and the rest move-assigned
+        if (i == 0 || i == n) {
+            if (i == 0) j = (j - 1) & mask;
+            construct(&a[(j + i) & mask], std::move(x));
+        } else if (i < n / 2) {
             // Shift left part left
-            j = (j == 0) ? a.size() - 1 : j - 1;
-            for (int k = 0; k <= i - 1; k++) {
-                a[(j + k) % a.size()] = a[(j + k + 1) % a.size()];
-            }
+            construct(&a[(j - 1) & mask], std::move(a[j]));
+            ringShift(a, mask, (j + 1) & mask, i - 1, -1);
+            j = (j - 1) & mask;
+            a[(j + i) & mask] = std::move(x);
         } else {
             // Shift right part right
-            for (int k = n; k > i; k--) {
-                a[(j + k) % a.size()] = a[(j + k - 1) % a.size()];
-            }
+            construct(&a[(j + n) & mask], std::move(a[(j + n - 1) & mask]));
+            ringShift(a, mask, (j + i) & mask, n - i - 1, 1);
+            a[(j + i) & mask] = std::move(x);
         }
-        a[(j + i) % a.size()] = x;
         n++;
     }
 
@@ -78,21 +240,19 @@ public:
         if (i < 0 || i >= n) {
             throw std::out_of_range("Index out of range");
         }
-        T x = a[(j + i) % a.size()];
+        T x = std::move(a[(j + i) & mask]);
         if (i < n / 2) {
-            // Shift left part right
-            for (int k = i; k > 0; k--) {
-                a[(j + k) % a.size()] = a[(j + k - 1) % a.size()];
-            }
-            j = (j + 1) % a.size();
+            // Shift left part right; the old head slot is left over
+            ringShift(a, mask, j, i, 1);
+            a[j].~T();
+            j = (j + 1) & mask;
         } else {
-            // Shift right part left
-            for (int k = i; k < n - 1; k++) {
-                a[(j + k) % a.size()] = a[(j + k + 1) % a.size()];
-            }
+            // Shift right part left; the old tail slot is left over
+            ringShift(a, mask, (j + i + 1) & mask, n - i - 1, -1);
+            a[(j + n - 1) & mask].~T();
         }
         n--;
-        if (3 * n < a.size()) {
+        if (3 * n < cap) {
             resize();
         }
         return x;
@@ -109,158 +269,1121 @@ public:
     }
 };
 
-template<typename T>
-class BDeque : public ArrayDeque<T> {
+template<typename T, typename Alloc = std::allocator<T>>
+class BDeque : public ArrayDeque<T, Alloc> {
+    int bound;   // at most b+1 elements; the array is rounded up to a power of two
+
 public:
-    BDeque(int b) {
-        this->n = 0;           // number of elements
-        this->j = 0;           // index of first element
-        this->a.resize(b+1);   // create array of size b+1
-    }
+    // room for b+1, rounded up to a power of two
+    BDeque(int b, const Alloc& alloc = Alloc())
+      : ArrayDeque<T, Alloc>(ceilPow2(b + 1), alloc), bound(b + 1) {}
     
     ~BDeque() { }        // C++ Question: Why is this necessary?
+
+    int capacity() const {
+        return bound;
+    }
     
     void add(int i, T x) {
-        ArrayDeque<T>::add(i, x);  // delegate to parent
+        if (this->n == bound) {
+            throw std::out_of_range("Invalid add position");
+        }
+        ArrayDeque<T, Alloc>::add(i, std::move(x));  // delegate to parent
     }
     
     bool add(T x) {
-        ArrayDeque<T>::add(this->size(), x);  // add at end
+        add(this->size(), std::move(x));  // add at end
         return true;
     }
+
+    // Move our last k elements to the front of dst
+    void moveBackTo(BDeque& dst, int k) {
+        if (k < 0 || k > this->n || dst.n + k > dst.bound) {
+            throw std::out_of_range("Invalid move count");
+        }
+        dst.j = (dst.j - k) & dst.mask;
+        ringRelocate(this->a, this->cap, (this->j + this->n - k) & this->mask,
+                     dst.a, dst.cap, dst.j, k);
+        this->n -= k;
+        dst.n += k;
+    }
+
+    // Discard our first k elements
+    void dropFront(int k) {
+        if (k < 0 || k > this->n) {
+            throw std::out_of_range("Invalid drop count");
+        }
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (int i = 0; i < k; i++) (*this)[i].~T();
+        }
+        this->j = (this->j + k) & this->mask;
+        this->n -= k;
+    }
+
+    // Move our first k elements to the back of dst
+    void moveFrontTo(BDeque& dst, int k) {
+        if (k < 0 || k > this->n || dst.n + k > dst.bound) {
+            throw std::out_of_range("Invalid move count");
+        }
+        ringRelocate(this->a, this->cap, this->j,
+                     dst.a, dst.cap, (dst.j + dst.n) & dst.mask, k);
+        this->j = (this->j + k) & this->mask;
+        this->n -= k;
+        dst.n += k;
+    }
     
     void resize() override {}     // override to prevent resizing
 };
 
-template<typename T>
+// Bounded deque with a compile-time bound of B+1 elements stored inline.
+// The slot count is rounded up to a power of two so index wrap is a mask,
+// and there is no vtable or separate heap buffer.
+template<typename T, int B>
+class FixedBDeque {
+private:
+    static constexpr int cap = ceilPow2(B + 1);
+    static constexpr int mask = cap - 1;
+
+    T a[cap];   // inline circular buffer
+    int n;      // number of elements
+    int j;      // index of first element
+
+public:
+    FixedBDeque(int = B) : n(0), j(0) {}
+
+    // the slots are inline and default-constructed, so an allocator only
+    // decides where the owning node lives, not the elements' own memory
+    template<typename A>
+    FixedBDeque(int, const A&) : n(0), j(0) {}
+
+    int size() const {
+        return n;
+    }
+
+    int capacity() const {
+        return B + 1;
+    }
+
+    void clear() {
+        n = 0;
+        j = 0;
+    }
+
+    T get(int i) const {
+        if (i < 0 || i >= n) {
+            throw std::out_of_range("Index out of range");
+        }
+        return a[(j + i) & mask];
+    }
+
+    T& operator[](int i) {
+        return a[(j + i) & mask];
+    }
+
+    const T& operator[](int i) const {
+        return a[(j + i) & mask];
+    }
+
+    T set(int i, const T& x) {
+        if (i < 0 || i >= n) {
+            throw std::out_of_range("Index out of range");
+        }
+        T y = a[(j + i) & mask];
+        a[(j + i) & mask] = x;
+        return y;
+    }
+
+    void add(int i, const T& x) {
+        if (i < 0 || i > n || n == B + 1) {
+            throw std::out_of_range("Invalid add position");
+        }
+        if (i < n / 2) {
+            // Shift left part left
+            ringShift(a, mask, j, i, -1);
+            j = (j - 1) & mask;
+        } else {
+            // Shift right part right
+            ringShift(a, mask, (j + i) & mask, n - i, 1);
+        }
+        a[(j + i) & mask] = x;
+        n++;
+    }
+
+    bool add(const T& x) {
+        add(n, x);
+        return true;
+    }
+
+    // Move our last k elements to the front of dst
+    void moveBackTo(FixedBDeque& dst, int k) {
+        if (k < 0 || k > n || dst.n + k > B + 1) {
+            throw std::out_of_range("Invalid move count");
+        }
+        dst.j = (dst.j - k) & mask;
+        ringMove(a, cap, (j + n - k) & mask, dst.a, cap, dst.j, k);
+        n -= k;
+        dst.n += k;
+    }
+
+    // Discard our first k elements
+    void dropFront(int k) {
+        if (k < 0 || k > n) {
+            throw std::out_of_range("Invalid drop count");
+        }
+        j = (j + k) & mask;
+        n -= k;
+    }
+
+    // Move our first k elements to the back of dst
+    void moveFrontTo(FixedBDeque& dst, int k) {
+        if (k < 0 || k > n || dst.n + k > B + 1) {
+            throw std::out_of_range("Invalid move count");
+        }
+        ringMove(a, cap, j, dst.a, cap, (dst.j + dst.n) & mask, k);
+        j = (j + k) & mask;
+        n -= k;
+        dst.n += k;
+    }
+
+    T remove(int i) {
+        if (i < 0 || i >= n) {
+            throw std::out_of_range("Index out of range");
+        }
+        T x = a[(j + i) & mask];
+        if (i < n / 2) {
+            // Shift left part right
+            ringShift(a, mask, j, i, 1);
+            j = (j + 1) & mask;
+        } else {
+            // Shift right part left
+            ringShift(a, mask, (j + i + 1) & mask, n - i - 1, -1);
+        }
+        n--;
+        return x;
+    }
+
+    void print() const {
+        std::cout << "[";
+        for (int i = 0; i < n; i++) {
+            std::cout << (*this)[i];
+            if (i < n - 1) std::cout << ", ";
+        }
+        std::cout << "]";
+    }
+};
+
+// Slab pool for SEList nodes.  Nodes are carved out of chunks of
+// chunkSize slots, so neighbouring blocks tend to sit close together, and
+// released nodes go on a free list with their deque storage intact.  A
+// node is reused as-is when its deque has the requested capacity; otherwise
+// it is rebuilt in place.  Memory goes back to the system only when the
+// pool is destroyed.  Lists share a pool through std::shared_ptr; the pool
+// itself is not thread-safe.  Slabs come from Alloc, and each node's deque
+// gets a copy of it for its buffer.  chunkNodes == 0 turns pooling off:
+// every node is allocated on its own and freed on release, as a baseline.
+template<typename Node, typename Alloc = std::allocator<Node>>
+class NodePool {
+private:
+    using Traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc;
+    std::vector<Node*> chunks;   // raw slabs of chunkSize slots
+    int chunkSize;
+    int used;                    // slots handed out from the last chunk
+    Node* freeList;              // released nodes, linked through next
+
+    long long requests;          // acquire() calls
+    long long fresh;             // nodes (and deque buffers) constructed
+    long long reused;            // nodes recycled with their storage
+
+public:
+    explicit NodePool(int chunkNodes = 64, const Alloc& alloc = Alloc())
+      : alloc(alloc), chunkSize(std::max(0, chunkNodes)), used(chunkSize), freeList(nullptr),
+        requests(0), fresh(0), reused(0) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        while (freeList != nullptr) {
+            Node* u = freeList;
+            freeList = u->next;
+            u->~Node();
+        }
+        for (Node* chunk : chunks) {
+            Traits::deallocate(alloc, chunk, chunkSize);
+        }
+    }
+
+    Node* acquire(int b) {
+        requests++;
+        if (chunkSize == 0) {
+            fresh++;
+            return new (Traits::allocate(alloc, 1)) Node(b, alloc);
+        }
+        if (freeList != nullptr) {
+            Node* u = freeList;
+            freeList = u->next;
+            if (u->d.capacity() == b + 1) {
+                u->d.clear();
+                u->prev = u->next = nullptr;
+                reused++;
+                return u;
+            }
+            u->~Node();
+            fresh++;
+            return new (u) Node(b, alloc);
+        }
+        if (used == chunkSize) {
+            chunks.push_back(Traits::allocate(alloc, chunkSize));
+            used = 0;
+        }
+        fresh++;
+        return new (chunks.back() + used++) Node(b, alloc);
+    }
+
+    void release(Node* u) {
+        if (chunkSize == 0) {
+            u->~Node();
+            Traits::deallocate(alloc, u, 1);
+            return;
+        }
+        u->d.clear();   // parked nodes hold no live elements
+        u->next = freeList;
+        freeList = u;
+    }
+
+    long long acquireCount() const { return requests; }
+    long long freshCount() const { return fresh; }
+    long long reuseCount() const { return reused; }
+    long long chunkCount() const { return chunks.size(); }
+    Alloc get_allocator() const { return alloc; }
+};
+
+// Index over a list's blocks: an implicit treap whose in-order sequence is
+// the block list.  The links live in the block nodes themselves, and each
+// subtree caches its block and element counts, so positional lookup,
+// inserting or unlinking a block anywhere and a block changing size are all
+// O(log(n/b)) expected.  cut/join split and concatenate whole runs of blocks
+// in O(log(n/b)).  Node needs d, left, right, parent, priority,
+// subtreeBlocks and subtreeElements.
+template<typename Node>
+class BlockTree {
+private:
+    Node* root;
+    std::uint32_t seed;   // xorshift state for priorities
+
+    static int blocksIn(const Node* t) { return t ? t->subtreeBlocks : 0; }
+    static int elementsIn(const Node* t) { return t ? t->subtreeElements : 0; }
+
+    // Recompute t's counts from its children and own block
+    static void pull(Node* t) {
+        t->subtreeBlocks = 1 + blocksIn(t->left) + blocksIn(t->right);
+        t->subtreeElements = t->d.size() + elementsIn(t->left) + elementsIn(t->right);
+        if (t->left) t->left->parent = t;
+        if (t->right) t->right->parent = t;
+    }
+
+    // The first k blocks of t go to l, the rest to r
+    static void split(Node* t, int k, Node*& l, Node*& r) {
+        if (t == nullptr) {
+            l = r = nullptr;
+            return;
+        }
+        if (blocksIn(t->left) < k) {
+            split(t->right, k - blocksIn(t->left) - 1, t->right, r);
+            l = t;
+        } else {
+            split(t->left, k, l, t->left);
+            r = t;
+        }
+        pull(t);
+    }
+
+    static Node* merge(Node* l, Node* r) {
+        if (l == nullptr) return r;
+        if (r == nullptr) return l;
+        if (l->priority > r->priority) {
+            l->right = merge(l->right, r);
+            pull(l);
+            return l;
+        }
+        r->left = merge(l, r->left);
+        pull(r);
+        return r;
+    }
+
+    // Number of blocks before x
+    static int rank(const Node* x) {
+        int k = blocksIn(x->left);
+        for (; x->parent != nullptr; x = x->parent) {
+            if (x == x->parent->right) k += blocksIn(x->parent->left) + 1;
+        }
+        return k;
+    }
+
+    void setRoot(Node* t) {
+        root = t;
+        if (t) t->parent = nullptr;
+    }
+
+    std::uint32_t nextPriority() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+public:
+    BlockTree() : root(nullptr), seed(0x9e3779b9u) {}
+
+    BlockTree(const BlockTree&) = delete;
+    BlockTree& operator=(const BlockTree&) = delete;
+
+    void swap(BlockTree& other) {
+        std::swap(root, other.root);
+        std::swap(seed, other.seed);
+    }
+
+    // Forget every block (the nodes themselves are not touched)
+    void clear() {
+        root = nullptr;
+    }
+
+    int blocks() const {
+        return blocksIn(root);
+    }
+
+    int elements() const {
+        return elementsIn(root);
+    }
+
+    // Insert block x before block at; nullptr appends
+    void insertBefore(Node* x, Node* at) {
+        x->left = x->right = nullptr;
+        x->priority = nextPriority();
+        pull(x);
+        if (at == nullptr) {
+            setRoot(merge(root, x));
+            return;
+        }
+        Node* l;
+        Node* r;
+        split(root, rank(at), l, r);
+        setRoot(merge(merge(l, x), r));
+    }
+
+    // Unlink block x: its children merge into its place
+    void erase(Node* x) {
+        Node* c = merge(x->left, x->right);
+        Node* p = x->parent;
+        if (p == nullptr) {
+            setRoot(c);
+            return;
+        }
+        (p->left == x ? p->left : p->right) = c;
+        if (c) c->parent = p;
+        resized(p);
+    }
+
+    // x's block changed size: refresh the counts on its path to the root
+    void resized(Node* x) {
+        for (; x != nullptr; x = x->parent) pull(x);
+    }
+
+    // Block holding element i (0 <= i < elements()); rem receives i's
+    // offset in it.  Empty blocks are never returned.
+    Node* find(int i, int& rem) const {
+        Node* t = root;
+        while (true) {
+            int before = elementsIn(t->left);
+            if (i < before) {
+                t = t->left;
+                continue;
+            }
+            i -= before;
+            if (i < t->d.size()) {
+                rem = i;
+                return t;
+            }
+            i -= t->d.size();
+            t = t->right;
+        }
+    }
+
+    // Detach block at and every block after it; the run is returned for
+    // join().  nullptr cuts nothing.
+    Node* cut(Node* at) {
+        if (at == nullptr) return nullptr;
+        Node* l;
+        Node* r;
+        split(root, rank(at), l, r);
+        setRoot(l);
+        if (r) r->parent = nullptr;
+        return r;
+    }
+
+    // Append a run from cut() or release()
+    void join(Node* run) {
+        setRoot(merge(root, run));
+    }
+
+    // Hand over every block as one run, leaving this index empty
+    Node* release() {
+        Node* t = root;
+        root = nullptr;
+        return t;
+    }
+};
+
+// B == 0 selects a runtime block size with heap-backed BDeque blocks;
+// B > 0 fixes the block size at compile time and stores each block's
+// elements inline in its node (FixedBDeque).  Nodes and block buffers come
+// from Alloc through the node pool, and the block index is linked through
+// the nodes.
+template<typename T, int B = 0, typename Alloc = std::allocator<T>>
 class SEList {
 private:
+    using Deque = typename std::conditional<B == 0, BDeque<T, Alloc>, FixedBDeque<T, B>>::type;
+
     struct Node {
-        BDeque<T> d;
+        Deque d;
         Node* prev;
         Node* next;
+        // BlockTree links and counts
+        Node* left;
+        Node* right;
+        Node* parent;
+        std::uint32_t priority;
+        int subtreeBlocks;
+        int subtreeElements;
+
+        template<typename A>
+        Node(int b, const A& alloc)
+          : d(b, Alloc(alloc)), prev(nullptr), next(nullptr), left(nullptr), right(nullptr),
+            parent(nullptr), priority(0), subtreeBlocks(1), subtreeElements(0) {}
+    };
+
+public:
+    using Pool = NodePool<Node, typename std::allocator_traits<Alloc>::template rebind_alloc<Node>>;
+
+private:
+
+    struct Location {
+        Node* u;
+        int j;
+        Location() : u(nullptr), j(0) {}
+        Location(Node* node, int index) : u(node), j(index) {}
+    };
+
+    int n;          // number of elements in this chain (see tail)
+    int b;          // block size
+    Node dummy;     // sentinel node
+    std::shared_ptr<Pool> pool;   // where blocks come from
+
+    // Block index, kept current by every block insert, unlink and resize
+    BlockTree<Node> index;
+
+    // Adaptive mode keeps b a power-of-two multiple of the initial size near
+    // sqrt(n).  When b changes, the current blocks move into tail (still at
+    // the old size) and every add/remove migrates a couple of tail blocks to
+    // the end of this chain until tail is empty.  Elements [0, n) live here,
+    // the rest in tail.
+    static const int minAdaptiveB = 2;
+    static const int reblockRate = 2;   // tail blocks migrated per operation
+    bool adaptive;
+    std::unique_ptr<SEList> tail;
+
+    // Finger: the block of the last resolved location and the global index
+    // of its first element.  Lookups near it walk from there instead of
+    // descending the index.  Any element move between blocks clears it.
+    static const int fingerReach = 8;   // max blocks walked from the finger
+    Node* finger;
+    int fingerStart;
+    bool fingerEnabled;
+
+    void setFinger(Node* u, int start) {
+        if (fingerEnabled) {
+            finger = u;
+            fingerStart = start;
+        }
+    }
+
+    // Resolve i by walking from the finger; false if it is too far away
+    bool fromFinger(int i, Location& ell) {
+        if (finger == nullptr) return false;
+        Node* u = finger;
+        int start = fingerStart;
+        for (int hops = 0; hops < fingerReach; hops++) {
+            if (i < start) {
+                u = u->prev;
+                start -= u->d.size();
+            } else if (i >= start + u->d.size()) {
+                start += u->d.size();
+                u = u->next;
+            } else {
+                break;
+            }
+        }
+        if (i < start || i >= start + u->d.size()) return false;
+        ell.u = u;
+        ell.j = i - start;
+        setFinger(u, start);
+        return true;
+    }
+
+    void resized(Node* u) {
+        finger = nullptr;
+        index.resized(u);
+    }
+
+    // Element moves between blocks go through these so the index stays in sync
+    void pushBack(Node* u, const T& x) {
+        u->d.add(x);
+        resized(u);
+    }
+
+    // Move the last k elements of from to the front of to
+    void moveBack(Node* from, Node* to, int k) {
+        from->d.moveBackTo(to->d, k);
+        resized(from);
+        resized(to);
+    }
+
+    // Move the first k elements of from to the back of to
+    void moveFront(Node* from, Node* to, int k) {
+        from->d.moveFrontTo(to->d, k);
+        resized(from);
+        resized(to);
+    }
+
+    void getLocation(int i, Location& ell) {
+        if (i < 0 || i >= n) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        if (fromFinger(i, ell)) return;
+        ell.u = index.find(i, ell.j);
+        setFinger(ell.u, i - ell.j);
+    }
+
+    Node* addBefore(Node* target) {
+        Node* newNode = pool->acquire(b);
+        newNode->next = target;
+        newNode->prev = target->prev;
+        target->prev->next = newNode;
+        target->prev = newNode;
+        index.insertBefore(newNode, target == &dummy ? nullptr : target);
+        return newNode;
+    }
+
+    void removeNode(Node* node) {
+        finger = nullptr;
+        index.erase(node);
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        pool->release(node);
+    }
+
+    void spread(Node* u) {
+        Node* w = u;
+        // Find position b blocks ahead or at the end
+        for (int j = 0; j < b && w != &dummy; j++) {
+            w = w->next;
+        }
+        // Create new empty block
+        w = addBefore(w);
+
+        // Redistribute elements backwards, one range per block
+        while (w != u) {
+            int k = std::min(b - w->d.size(), w->prev->d.size());
+            if (k > 0) moveBack(w->prev, w, k);
+            w = w->prev;
+        }
+    }
+
+    void gather(Node* u) {
+        Node* w = u;
+        // Collect elements from up to b blocks
+        for (int j = 0; j < b - 1 && w->next != &dummy; j++) {
+            int k = std::min(b - w->d.size(), w->next->d.size());
+            if (k > 0) moveFront(w->next, w, k);
+            w = w->next;
+        }
+        
+        // Remove empty blocks
+        while (w != u && w != &dummy) {
+            Node* toRemove = w;
+            w = w->prev;
+            if (toRemove->d.size() == 0) {
+                removeNode(toRemove);
+            }
+        }
+    }
+
+    // Cut block u after its first j elements; the rest go to a new block
+    // right after u, which is returned
+    Node* splitBlock(Node* u, int j) {
+        Node* r = addBefore(u->next);
+        moveBack(u, r, u->d.size() - j);
+        return r;
+    }
+
+    // First block of the part of this chain starting at index i, cutting a
+    // block if i falls inside one; &dummy when i == n
+    Node* cutAt(int i) {
+        if (i == n) return &dummy;
+        Location ell;
+        getLocation(i, ell);
+        return ell.j > 0 ? splitBlock(ell.u, ell.j) : ell.u;
+    }
+
+    bool blockValid(Node* w) const {
+        int s = w->d.size();
+        return w->next == &dummy ? s >= 1 && s <= b + 1 : s >= b - 1 && s <= b + 1;
+    }
+
+    // Restore the block-size invariant at r, whose size may be anything in
+    // [0, b+1] while every block after it is valid.  Finds the shortest run
+    // of blocks from r whose total can be cut into valid blocks (at most
+    // about b/2 of them) and re-chunks it with range moves.  That is O(b^2)
+    // element moves in the worst case: a valid block has at most two slots
+    // of slack, so a short block at a cut can need about b/2 neighbours to
+    // make up its deficit, and every element between them shifts.  Cheaper
+    // junctions would need looser block bounds than validate() allows.
+    void repair(Node* r) {
+        if (r == &dummy || blockValid(r)) return;
+        Node* last = r;
+        int m = 1;
+        int c = r->d.size();
+        bool atEnd;
+        int parts;
+        while (true) {
+            atEnd = last->next == &dummy;
+            if (atEnd) {
+                parts = (c + b) / (b + 1);
+                break;
+            }
+            if (m >= 2 && c >= (m - 1) * (b - 1) && c <= (m - 1) * (b + 1)) {
+                parts = m - 1;
+                break;
+            }
+            if (c >= m * (b - 1) && c <= m * (b + 1)) {
+                parts = m;
+                break;
+            }
+            last = last->next;
+            m++;
+            c += last->d.size();
+        }
+
+        // Stream the run into fresh blocks: full blocks and a remainder at
+        // the end of the list, otherwise sizes as even as possible
+        Node* stop = last->next;
+        Node* src = r;
+        for (int k = 0; k < parts; k++) {
+            int need;
+            if (atEnd) {
+                need = k < parts - 1 ? b + 1 : c - (parts - 1) * (b + 1);
+            } else {
+                need = c / parts + (k < c % parts ? 1 : 0);
+            }
+            Node* dst = addBefore(r);
+            while (need > 0) {
+                int take = std::min(need, src->d.size());
+                if (take > 0) moveFront(src, dst, take);
+                need -= take;
+                if (src->d.size() == 0) {
+                    Node* next = src->next;
+                    if (src == r) r = next;
+                    removeNode(src);
+                    src = next;
+                }
+            }
+        }
+        while (src != stop) {
+            Node* next = src->next;
+            removeNode(src);
+            src = next;
+        }
+    }
+
+    // Erase [i, j) from this chain, 0 <= i < j <= n.  Whole blocks inside
+    // the range are unlinked; only the blocks at the two edges are cut and
+    // repaired.
+    void eraseHere(int i, int j) {
+        Node* w = cutAt(i);
+        Node* left = w->prev;
+        int remaining = j - i;
+        while (remaining > 0 && remaining >= w->d.size()) {
+            remaining -= w->d.size();
+            Node* next = w->next;
+            removeNode(w);
+            w = next;
+        }
+        if (remaining > 0) {
+            w->d.dropFront(remaining);
+            resized(w);
+        }
+        n -= j - i;
+
+        repair(w);
+        if (left != &dummy) repair(left);
+    }
+
+    // Append to this chain, filling the last block up to b+1
+    void append(const T& x) {
+        Node* last = dummy.prev;
+        if (last == &dummy || last->d.size() == b + 1) {
+            last = addBefore(&dummy);
+        }
+        pushBack(last, x);
+        n++;
+        setFinger(last, n - last->d.size());
+    }
+
+    // Begin re-blocking to block size newB: our blocks become the tail
+    void startReblock(int newB) {
+        if (n == 0) {
+            b = newB;
+            return;
+        }
+        tail.reset(new SEList(b, pool));
+        tail->dummy.next = dummy.next;
+        tail->dummy.prev = dummy.prev;
+        dummy.next->prev = &tail->dummy;
+        dummy.prev->next = &tail->dummy;
+        tail->n = n;
+        tail->index.swap(index);
+
+        dummy.next = dummy.prev = &dummy;
+        n = 0;
+        finger = nullptr;
+        b = newB;
+    }
+
+    // Move the first tail block onto the end of this chain
+    void migrateBlock() {
+        Node* u = tail->dummy.next;
+        while (u->d.size() > 0) {
+            Node* last = dummy.prev;
+            if (last == &dummy || last->d.size() == b + 1) {
+                last = addBefore(&dummy);
+            }
+            int k = std::min(b + 1 - last->d.size(), u->d.size());
+            u->d.moveFrontTo(last->d, k);
+            tail->resized(u);
+            resized(last);
+            tail->n -= k;
+            n += k;
+        }
+        tail->removeNode(u);
+        if (tail->n == 0) {
+            tail.reset();
+        }
+    }
+
+    void finishReblock() {
+        while (tail) {
+            migrateBlock();
+        }
+    }
+
+    // Called after every add/remove in adaptive mode: advance a running
+    // migration, or start one when n has left [b^2/4, 4b^2)
+    void reblock() {
+        if (!adaptive) return;
+        if (tail) {
+            for (int k = 0; k < reblockRate && tail; k++) {
+                migrateBlock();
+            }
+            return;
+        }
+        long long bb = (long long)b * b;
+        if (n >= 4 * bb) {
+            startReblock(2 * b);
+        } else if (b / 2 >= minAdaptiveB && 4LL * n < bb) {
+            startReblock(b / 2);
+        }
+    }
+
+    // Insert into this chain at 0 <= i < n
+    void insertAt(int i, const T& x) {
+        Location ell;
+        getLocation(i, ell);
+        Node* u = ell.u;
+        int r = 0;
+
+        // Look for space within b blocks
+        Node* temp = u;
+        while (r < b && temp != &dummy && temp->d.size() == b + 1) {
+            temp = temp->next;
+            r++;
+        }
+
+        if (r == b) {
+            // Case 3: b blocks each with b+1 elements - need to spread
+            spread(u);
+            // After spreading, we can insert at the original location
+        } else if (temp == &dummy) {
+            // Case 2: ran off the end - add new node
+            temp = addBefore(&dummy);
+        }
+
+        // Find the actual insertion point after potential spreading
+        u = ell.u;
+        while (u->d.size() == b + 1 && u->next != &dummy) {
+            u = u->next;
+        }
+
+        // Work backwards, shifting elements
+        while (u != ell.u) {
+            if (u->prev->d.size() > 0) {
+                moveBack(u->prev, u, 1);
+            }
+            u = u->prev;
+        }
+
+        u->d.add(ell.j, x);
+        resized(u);
+        n++;
+        // Blocks before ell.u were not touched, so its start is unchanged
+        setFinger(u, i - ell.j);
+    }
+
+    // Remove from this chain at 0 <= i < n
+    T removeAt(int i) {
+        Location ell;
+        getLocation(i, ell);
+        T y = ell.u->d.get(ell.j);
 
-        Node(int b) : d(b), prev(nullptr), next(nullptr) {}
-    };
+        // Look for a block with a spare element within b blocks
+        Node* u = ell.u;
+        int r = 0;
+        while (r < b && u != &dummy && u->d.size() == b - 1) {
+            u = u->next;
+            r++;
+        }
 
-    struct Location {
-        Node* u;
-        int j;
-        Location() : u(nullptr), j(0) {}
-        Location(Node* node, int index) : u(node), j(index) {}
-    };
+        if (r == b) {
+            // b blocks each with b-1 elements - gather them into b-1 blocks
+            gather(ell.u);
+        }
 
-    int n;          // total number of elements
-    int b;          // block size
-    Node dummy;     // sentinel node
+        u = ell.u;
+        u->d.remove(ell.j);
+        resized(u);
 
-    void getLocation(int i, Location& ell) {
-        if (i < 0 || i >= n) {
-            throw std::out_of_range("Index out of range");
+        // Pull one element forward through each underfull block
+        while (u->d.size() < b - 1 && u->next != &dummy) {
+            moveFront(u->next, u, 1);
+            u = u->next;
         }
 
-        if (i < n / 2) {
-            // Search forward
-            Node* u = dummy.next;
-            while (i >= u->d.size()) {
-                i -= u->d.size();
-                u = u->next;
-            }
-            ell.u = u;
-            ell.j = i;
-        } else {
-            // Search backward
-            Node* u = &dummy;
-            int idx = n;
-            while (i < idx) {
-                u = u->prev;
-                idx -= u->d.size();
-            }
-            ell.u = u;
-            ell.j = i - idx;
+        // Remove empty blocks
+        bool keepFinger = u != ell.u || u->d.size() > 0;
+        if (u->d.size() == 0) {
+            removeNode(u);
         }
-    }
 
-    Node* addBefore(Node* target) {
-        Node* newNode = new Node(b);
-        newNode->next = target;
-        newNode->prev = target->prev;
-        target->prev->next = newNode;
-        target->prev = newNode;
-        return newNode;
+        n--;
+        if (keepFinger) {
+            // Nothing before ell.u moved, so its start index is unchanged
+            setFinger(ell.u, i - ell.j);
+        }
+        return y;
     }
 
-    void removeNode(Node* node) {
-        node->prev->next = node->next;
-        node->next->prev = node->prev;
-        delete node;
-    }
+    // Bidirectional iterator: a block plus a position inside its deque.
+    // Steps within the block and hops to next/prev at block boundaries,
+    // and from the end of this chain into the tail while re-blocking.
+    template<bool Const>
+    class Iter {
+    private:
+        friend class SEList;
+        friend class Iter<!Const>;
+        using NodePtr = typename std::conditional<Const, const Node*, Node*>::type;
+        using ListPtr = typename std::conditional<Const, const SEList*, SEList*>::type;
 
-    void spread(Node* u) {
-        Node* w = u;
-        // Find position b blocks ahead or at the end
-        for (int j = 0; j < b && w->next != &dummy; j++) {
-            w = w->next;
-        }
-        // Create new empty block
-        w = addBefore(w);
+        ListPtr list;
+        NodePtr u;
+        int j;
 
-        // Redistribute elements backwards
-        while (w != u) {
-            while (w->d.size() < b && w->prev->d.size() > 0) {
-                T x = w->prev->d.remove(w->prev->d.size() - 1);
-                w->d.add(0, x);
+        Iter(ListPtr owner, NodePtr node, int index) : list(owner), u(node), j(index) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T*, T*>::type;
+        using reference = typename std::conditional<Const, const T&, T&>::type;
+
+        Iter() : list(nullptr), u(nullptr), j(0) {}
+
+        // iterator -> const_iterator
+        template<bool C = Const, typename = typename std::enable_if<C>::type>
+        Iter(const Iter<false>& other) : list(other.list), u(other.u), j(other.j) {}
+
+        reference operator*() const { return u->d[j]; }
+        pointer operator->() const { return &u->d[j]; }
+
+        Iter& operator++() {
+            if (++j == u->d.size()) {
+                u = u->next;
+                j = 0;
+                if (u == &list->dummy && list->tail) u = list->tail->dummy.next;
             }
-            w = w->prev;
+            return *this;
         }
-    }
 
-    void gather(Node* u) {
-        Node* w = u;
-        // Collect elements from up to b blocks
-        for (int j = 0; j < b - 1 && w->next != &dummy; j++) {
-            while (w->d.size() < b && w->next->d.size() > 0) {
-                T x = w->next->d.remove(0);
-                w->d.add(x);
-            }
-            w = w->next;
+        Iter operator++(int) {
+            Iter old = *this;
+            ++*this;
+            return old;
         }
-        
-        // Remove empty blocks
-        while (w != u && w != &dummy) {
-            Node* toRemove = w;
-            w = w->prev;
-            if (toRemove->d.size() == 0) {
-                removeNode(toRemove);
+
+        Iter& operator--() {
+            if (j == 0) {
+                u = u->prev;
+                if (list->tail && u == &list->tail->dummy) u = list->dummy.prev;
+                j = u->d.size();
             }
+            --j;
+            return *this;
+        }
+
+        Iter operator--(int) {
+            Iter old = *this;
+            --*this;
+            return old;
         }
-    }
+
+        bool operator==(const Iter& other) const { return u == other.u && j == other.j; }
+        bool operator!=(const Iter& other) const { return !(*this == other); }
+    };
 
 public:
-    SEList(int blockSize = 3) : n(0), b(blockSize), dummy(blockSize) {
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    // A shared pool brings its own allocator; alloc is used only without one
+    SEList(int blockSize = B == 0 ? 3 : B, std::shared_ptr<Pool> nodePool = nullptr,
+           const Alloc& alloc = Alloc())
+      : n(0), b(B == 0 ? blockSize : B),
+        dummy(b, nodePool ? Alloc(nodePool->get_allocator()) : alloc),
+        pool(nodePool ? nodePool : std::make_shared<Pool>(64, alloc)),
+        adaptive(false), finger(nullptr), fingerStart(0), fingerEnabled(true) {
         dummy.next = &dummy;
         dummy.prev = &dummy;
     }
 
+    SEList(SEList&& other) : SEList(other.b, other.pool) {
+        swap(other);
+    }
+
+    SEList& operator=(SEList&& other) {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
     ~SEList() {
         clear();
     }
 
+    void swap(SEList& other) {
+        Node* first = dummy.next;
+        Node* last = dummy.prev;
+        Node* otherFirst = other.dummy.next;
+        Node* otherLast = other.dummy.prev;
+        dummy.next = dummy.prev = &dummy;
+        other.dummy.next = other.dummy.prev = &other.dummy;
+        if (otherFirst != &other.dummy) {
+            dummy.next = otherFirst;
+            dummy.prev = otherLast;
+            otherFirst->prev = otherLast->next = &dummy;
+        }
+        if (first != &dummy) {
+            other.dummy.next = first;
+            other.dummy.prev = last;
+            first->prev = last->next = &other.dummy;
+        }
+        std::swap(n, other.n);
+        std::swap(b, other.b);
+        std::swap(pool, other.pool);
+        index.swap(other.index);
+        std::swap(adaptive, other.adaptive);
+        std::swap(tail, other.tail);
+        std::swap(fingerEnabled, other.fingerEnabled);
+        finger = other.finger = nullptr;
+    }
+
     int size() const {
-        return n;
+        return n + (tail ? tail->n : 0);
     }
 
     bool empty() const {
-        return n == 0;
+        return size() == 0;
+    }
+
+    iterator begin() {
+        Node* first = (n == 0 && tail) ? tail->dummy.next : dummy.next;
+        return iterator(this, first, 0);
+    }
+    iterator end() { return iterator(this, tail ? &tail->dummy : &dummy, 0); }
+    const_iterator begin() const {
+        const Node* first = (n == 0 && tail) ? tail->dummy.next : dummy.next;
+        return const_iterator(this, first, 0);
+    }
+    const_iterator end() const { return const_iterator(this, tail ? &tail->dummy : &dummy, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // The node pool; pass it to another list's constructor to share it
+    std::shared_ptr<Pool> nodePool() const {
+        return pool;
+    }
+
+    // Current block size; changes over time in adaptive mode
+    int blockSize() const {
+        return b;
+    }
+
+    // Adaptive mode re-blocks incrementally so b tracks sqrt(n).  Only
+    // available with a runtime block size (B == 0).  Turning it off
+    // finishes any migration in progress.
+    void setAdaptive(bool on) {
+        adaptive = on && B == 0;
+        if (!adaptive) finishReblock();
+        reblock();
+    }
+
+    bool isAdaptive() const {
+        return adaptive;
+    }
+
+    // True while blocks of the previous size are still being migrated
+    bool reblocking() const {
+        return tail != nullptr;
+    }
+
+    // Turn the finger cache on or off (on by default)
+    void setFingerEnabled(bool enabled) {
+        fingerEnabled = enabled;
+        finger = nullptr;
     }
 
     T get(int i) {
+        if (tail && i >= n) return tail->get(i - n);
         Location ell;
         getLocation(i, ell);
         return ell.u->d.get(ell.j);
     }
 
     T set(int i, const T& x) {
+        if (tail && i >= n) return tail->set(i - n, x);
         Location ell;
         getLocation(i, ell);
         T y = ell.u->d.get(ell.j);
@@ -269,114 +1392,185 @@ public:
     }
 
     void add(const T& x) {
-        Node* last = dummy.prev;
-        if (last == &dummy || last->d.size() == b + 1) {
-            last = addBefore(&dummy);
+        if (tail) {
+            tail->add(x);
+        } else {
+            append(x);
         }
-        last->d.add(x);
-        n++;
+        reblock();
     }
 
     void add(int i, const T& x) {
-        if (i < 0 || i > n) {
+        if (i < 0 || i > size()) {
             throw std::out_of_range("Index out of range");
         }
 
-        if (i == n) {
-            add(x);
-            return;
+        if (tail && i > n) {
+            tail->add(i - n, x);
+        } else if (i == n) {
+            append(x);
+        } else {
+            insertAt(i, x);
         }
+        reblock();
+    }
 
-        Location ell;
-        getLocation(i, ell);
-        Node* u = ell.u;
-        int r = 0;
-
-        // Look for space within b blocks
-        Node* temp = u;
-        while (r < b && temp != &dummy && temp->d.size() == b + 1) {
-            temp = temp->next;
-            r++;
+    T remove(int i) {
+        if (i < 0 || i >= size()) {
+            throw std::out_of_range("Index out of range");
         }
 
-        if (r == b) {
-            // Case 3: b blocks each with b+1 elements - need to spread
-            spread(u);
-            // After spreading, we can insert at the original location
-        } else if (temp == &dummy) {
-            // Case 2: ran off the end - add new node
-            temp = addBefore(&dummy);
+        T y = (tail && i >= n) ? tail->remove(i - n) : removeAt(i);
+        if (tail && tail->n == 0) {
+            tail.reset();
         }
+        reblock();
+        return y;
+    }
 
-        // Find the actual insertion point after potential spreading
-        u = ell.u;
-        while (u->d.size() == b + 1 && u->next != &dummy) {
-            u = u->next;
+
+
+
+    // Range operations never finish a re-block in progress: each chain
+    // handles its own part, the tail at the old block size.
+
+    // Insert the elements of [first, last) before index i.  They are packed
+    // into fresh blocks and spliced in, so the existing list only does
+    // O(b) work at the junctions.
+    template<typename InputIt>
+    void insert(int i, InputIt first, InputIt last) {
+        if (i < 0 || i > size()) {
+            throw std::out_of_range("Index out of range");
         }
+        if (tail && i > n) {
+            tail->insert(i - n, first, last);
+            reblock();
+            return;
+        }
+        SEList run(b, pool);
+        for (; first != last; ++first) {
+            run.append(*first);
+        }
+        splice(i, std::move(run));
+    }
 
-        // Work backwards, shifting elements
-        while (u != ell.u) {
-            if (u->prev->d.size() > 0) {
-                T x = u->prev->d.remove(u->prev->d.size() - 1);
-                u->d.add(0, x);
+    // Erase elements [i, j) in O(b^2 + (j-i)/b log(n/b)); see eraseHere
+    void erase(int i, int j) {
+        if (i < 0 || j > size() || i > j) {
+            throw std::out_of_range("Invalid erase range");
+        }
+        if (i == j) return;
+        if (tail && j > n) {
+            tail->erase(std::max(i - n, 0), j - n);
+            if (tail->n == 0) {
+                tail.reset();
             }
-            u = u->prev;
+            j = std::min(j, n);
         }
-
-        u->d.add(ell.j, x);
-        n++;
+        if (i < j) {
+            eraseHere(i, j);
+        }
+        reblock();
     }
 
-    T remove(int i) {
-        if (i < 0 || i >= n) {
+    // Move all of other's elements in before index i, leaving other empty.
+    // Blocks are relinked when both lists have the same block size and
+    // share a node pool; otherwise the elements are copied.
+    void splice(int i, SEList&& other) {
+        if (i < 0 || i > size()) {
             throw std::out_of_range("Index out of range");
         }
+        if (&other == this || other.empty()) return;
+        if (tail && i > n) {
+            tail->splice(i - n, std::move(other));
+            reblock();
+            return;
+        }
+        // other's elements all move anyway, so finishing its own re-block
+        // costs O(other.size())
+        other.finishReblock();
+        if (other.b != b || other.pool != pool) {
+            insert(i, other.begin(), other.end());
+            other.clear();
+            return;
+        }
 
-        Location ell;
-        getLocation(i, ell);
-        T y = ell.u->d.get(ell.j);
+        Node* first = other.dummy.next;
+        Node* last = other.dummy.prev;
+        int k = other.n;
+        Node* run = other.index.release();
+        other.dummy.next = other.dummy.prev = &other.dummy;
+        other.clear();
 
-        Node* u = ell.u;
-        u->d.remove(ell.j);
+        Node* at = cutAt(i);
+        Node* rest = index.cut(at == &dummy ? nullptr : at);
+        index.join(run);
+        index.join(rest);
+        Node* before = at->prev;
+        before->next = first;
+        first->prev = before;
+        last->next = at;
+        at->prev = last;
+        n += k;
+        finger = nullptr;
 
-        // Check if we need to gather elements
-        if (u->d.size() < b - 1) {
-            // Count consecutive blocks with size < b
-            Node* temp = u;
-            int consecutiveSmall = 0;
-            while (temp != &dummy && temp->d.size() < b) {
-                consecutiveSmall++;
-                temp = temp->next;
-            }
-            
-            if (consecutiveSmall >= b) {
-                gather(u);
-            } else {
-                // Borrow from adjacent blocks
-                while (u->d.size() < b - 1 && u->next != &dummy && u->next->d.size() > b - 1) {
-                    T x = u->next->d.remove(0);
-                    u->d.add(x);
-                }
-                while (u->d.size() < b - 1 && u->prev != &dummy && u->prev->d.size() > b - 1) {
-                    T x = u->prev->d.remove(u->prev->d.size() - 1);
-                    u->d.add(0, x);
-                }
+        // Right to left, so each repair sees valid blocks after it
+        repair(at);
+        repair(last);
+        if (before != &dummy) repair(before);
+        reblock();
+    }
+
+    // Cut the list at index i: elements [i, size()) move to the returned
+    // list (same node pool and adaptive setting, block size of the chain
+    // cut) by relinking blocks
+    SEList split(int i) {
+        if (i < 0 || i > size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (tail && i >= n) {
+            SEList out = tail->split(i - n);
+            out.adaptive = adaptive;
+            if (tail->n == 0) {
+                tail.reset();
             }
+            reblock();
+            return out;
         }
+        SEList out(b, pool);
+        out.adaptive = adaptive;
+        if (i == n) return out;
 
-        // Remove empty blocks
-        if (u->d.size() == 0 && u != &dummy) {
-            removeNode(u);
+        Node* first = cutAt(i);
+        out.index.join(index.cut(first));
+        Node* last = dummy.prev;
+        Node* before = first->prev;
+        before->next = &dummy;
+        dummy.prev = before;
+        out.dummy.next = first;
+        out.dummy.prev = last;
+        first->prev = last->next = &out.dummy;
+        out.n = n - i;
+        n = i;
+        finger = nullptr;
+        if (tail) {
+            // the unmigrated blocks follow the cut, so they go along and
+            // out carries on the migration
+            out.tail = std::move(tail);
         }
 
-        n--;
-        return y;
+        out.repair(first);
+        reblock();
+        return out;
     }
 
     void clear() {
         while (dummy.next != &dummy) {
             removeNode(dummy.next);
         }
+        index.clear();
+        finger = nullptr;
+        tail.reset();
         n = 0;
     }
       void print() const {
@@ -388,6 +1582,10 @@ public:
             if (current != &dummy) std::cout << " -> ";
         }
         std::cout << std::endl;
+        if (tail) {
+            std::cout << "  re-blocking, not yet migrated: ";
+            tail->print();
+        }
     }
    void printDetailed() const {
         std::cout << "=== SEList Detailed View ===" << std::endl;
@@ -408,6 +1606,10 @@ public:
             current = current->next;
         }
         std::cout << "=========================" << std::endl;
+        if (tail) {
+            std::cout << "Re-blocking; blocks not yet migrated:" << std::endl;
+            tail->printDetailed();
+        }
     }
    bool validate() const {
         Node* current = dummy.next;
@@ -442,11 +1644,117 @@ public:
                       << " but n=" << n << std::endl;
             return false;
         }
-        
-        return true;
+        if (index.blocks() != blockCount || index.elements() != n) {
+            std::cout << "Block index out of sync: " << index.blocks() << " blocks, "
+                      << index.elements() << " elements" << std::endl;
+            return false;
+        }
+
+        // While re-blocking, the tail is checked against its own block size
+        return !tail || tail->validate();
+    }
+};
+
+
+// Scan-with-jitter workload: get(i), get(i+1), get(i +/- small) ...
+// Returns nanoseconds per get().
+double benchJitterScan(SEList<int>& list) {
+    unsigned seed = 12345;
+    long long sum = 0;
+    int n = list.size();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        int k = i + (int)((seed >> 16) % 9) - 4;
+        if (k < 0) k = 0;
+        if (k >= n) k = n - 1;
+        sum += list.get(k);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (sum == 42) std::cout << "";  // keep the loop alive
+    return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+// Appends, then random inserts, then random gets; returns milliseconds
+template<typename List>
+double benchRandomOps(List& list, int appends, int inserts, int gets) {
+    unsigned seed = 777;
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < appends; i++) {
+        list.add(i);
+    }
+    for (int i = 0; i < inserts; i++) {
+        seed = seed * 1103515245 + 12345;
+        list.add((seed >> 8) % (list.size() + 1), i);
+    }
+    for (int i = 0; i < gets; i++) {
+        seed = seed * 1103515245 + 12345;
+        sum += list.get((seed >> 8) % list.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (sum == 42) std::cout << "";  // keep the loop alive
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Allocator that counts allocate() calls into a shared counter
+template<typename T>
+struct CountingAlloc {
+    using value_type = T;
+    long long* calls;
+    static inline long long unattributed = 0;
+
+    // default-constructed copies (SEList's default argument) count apart
+    CountingAlloc() : calls(&unattributed) {}
+    explicit CountingAlloc(long long* counter) : calls(counter) {}
+    template<typename U>
+    CountingAlloc(const CountingAlloc<U>& other) : calls(other.calls) {}
+
+    T* allocate(std::size_t k) {
+        ++*calls;
+        return std::allocator<T>().allocate(k);
+    }
+    void deallocate(T* p, std::size_t k) {
+        std::allocator<T>().deallocate(p, k);
+    }
+
+    friend bool operator==(const CountingAlloc& a, const CountingAlloc& b) {
+        return a.calls == b.calls;
     }
 };
 
+// Insert/erase churn on two lists sharing one pool, with every allocation
+// counted; chunkNodes == 0 runs the same workload without pooling
+void churnAllocations(int chunkNodes) {
+    using List = SEList<int, 0, CountingAlloc<int>>;
+    long long calls = 0;
+    auto pool = std::make_shared<List::Pool>(chunkNodes, CountingAlloc<int>(&calls));
+    bool valid;
+    {
+        List churnA(4, pool);
+        List churnB(4, pool);
+        unsigned churnSeed = 99;
+        for (int round = 0; round < 20; round++) {
+            List& target = round % 2 ? churnA : churnB;
+            for (int i = 0; i < 5000; i++) {
+                churnSeed = churnSeed * 1103515245 + 12345;
+                target.add((churnSeed >> 8) % (target.size() + 1), i);
+            }
+            while (target.size() > 100) {
+                churnSeed = churnSeed * 1103515245 + 12345;
+                target.remove((churnSeed >> 8) % target.size());
+            }
+        }
+        valid = churnA.validate() && churnB.validate();
+    }
+    std::cout << (chunkNodes == 0 ? "Without pool: " : "With pool:    ")
+              << pool->acquireCount() << " node requests, " << calls << " allocations";
+    if (chunkNodes > 0) {
+        std::cout << " (" << pool->chunkCount() << " chunks, " << pool->freshCount()
+                  << " deque buffers, " << pool->reuseCount() << " nodes reused)";
+    }
+    std::cout << (valid ? " ✓" : " ✗ lists invalid") << std::endl;
+}
 
 // Test and demonstration code
 int main() {
@@ -473,8 +1781,12 @@ int main() {
     std::cout << " (size: " << bdeque.size() << ")" << std::endl;
     
     // Test capacity limit - BDeque should not resize beyond initial size
-    std::cout << "Trying to add 4th element (should work since capacity is 4): ";
-    bdeque.add(40);
+    std::cout << "Trying to add 5th element (capacity is 4): ";
+    try {
+        bdeque.add(40);
+    } catch (const std::out_of_range& e) {
+        std::cout << "rejected (" << e.what() << ") ";
+    }
     bdeque.print();
     std::cout << " (size: " << bdeque.size() << ")" << std::endl;
     
@@ -483,6 +1795,22 @@ int main() {
     std::cout << "Removed element at position 1: " << removed << ", result: ";
     bdeque.print();
     std::cout << std::endl;
+
+    // Bulk moves between bounded deques
+    BDeque<int> other(3);
+    other.add(1);
+    bdeque.moveBackTo(other, 2);
+    std::cout << "Moved last 2 to front of other: ";
+    bdeque.print();
+    std::cout << " ";
+    other.print();
+    std::cout << std::endl;
+    other.moveFrontTo(bdeque, 2);
+    std::cout << "Moved first 2 of other back: ";
+    bdeque.print();
+    std::cout << " ";
+    other.print();
+    std::cout << std::endl;
     
     std::cout << "\n=== Testing SEList ===" << std::endl;
     
@@ -570,6 +1898,191 @@ int main() {
     if (smallList.validate()) {
         std::cout << "✓ Small list validation passed!" << std::endl;
     }
+
+    std::cout << "\n11. Indexed lookup on a larger list:" << std::endl;
+    SEList<int> bigList(8);
+    std::vector<int> reference;
+    for (int i = 0; i < 5000; i++) {
+        int pos = (i * 7919) % (reference.size() + 1);
+        bigList.add(pos, i);
+        reference.insert(reference.begin() + pos, i);
+    }
+    for (int i = 0; i < 2000; i++) {
+        int pos = (i * 104729) % reference.size();
+        bigList.remove(pos);
+        reference.erase(reference.begin() + pos);
+    }
+    bool matches = bigList.validate() && bigList.size() == (int)reference.size();
+    for (int i = 0; i < (int)reference.size() && matches; i++) {
+        matches = bigList.get(i) == reference[i];
+    }
+    std::cout << (matches ? "✓" : "✗") << " " << bigList.size()
+              << " elements match reference after mixed inserts/removes" << std::endl;
+
+    std::cout << "\n12. Finger cache on a scan with jitter:" << std::endl;
+    SEList<int> scanList(32);
+    for (int i = 0; i < 1000000; i++) {
+        scanList.add(i);
+    }
+    scanList.setFingerEnabled(false);
+    double cold = benchJitterScan(scanList);
+    scanList.setFingerEnabled(true);
+    double warm = benchJitterScan(scanList);
+    std::cout << "Without finger: " << cold << " ns/get" << std::endl;
+    std::cout << "With finger:    " << warm << " ns/get" << std::endl;
+
+    std::cout << "\n13. Iterators:" << std::endl;
+    SEList<int> iterList(3);
+    for (int i = 1; i <= 10; i++) {
+        iterList.add(i);
+    }
+    for (int& x : iterList) {
+        x *= 10;
+    }
+    std::cout << "Range-for: ";
+    for (int x : iterList) {
+        std::cout << x << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "Reversed:  ";
+    for (auto it = iterList.end(); it != iterList.begin(); ) {
+        std::cout << *--it << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "std::accumulate: "
+              << std::accumulate(iterList.cbegin(), iterList.cend(), 0) << std::endl;
+
+    auto t0 = std::chrono::steady_clock::now();
+    long long byIndex = 0;
+    for (int i = 0; i < scanList.size(); i++) {
+        byIndex += scanList.get(i);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    long long byIter = std::accumulate(scanList.begin(), scanList.end(), 0LL);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "Full scan of " << scanList.size() << " elements: get(i) "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, iterator "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms"
+              << (byIndex == byIter ? "" : " (sums differ!)") << std::endl;
+
+    std::cout << "\n14. Compile-time block size (inline blocks):" << std::endl;
+    SEList<int> dynamicList(31);
+    SEList<int, 31> fixedList;
+    double dynamicMs = benchRandomOps(dynamicList, 1000000, 20000, 1000000);
+    double fixedMs = benchRandomOps(fixedList, 1000000, 20000, 1000000);
+    bool same = dynamicList.size() == fixedList.size() && fixedList.validate();
+    for (int i = 0; i < fixedList.size() && same; i++) {
+        same = dynamicList.get(i) == fixedList.get(i);
+    }
+    std::cout << "SEList<int>(31):  " << dynamicMs << " ms" << std::endl;
+    std::cout << "SEList<int, 31>:  " << fixedMs << " ms"
+              << (same ? "" : " (contents differ!)") << std::endl;
+
+    std::cout << "\n15. Node pool under insert/erase churn:" << std::endl;
+    churnAllocations(0);
+    churnAllocations(64);
+
+    std::cout << "\n16. Adaptive block size:" << std::endl;
+    SEList<int> adaptiveList(2);
+    adaptiveList.setAdaptive(true);
+    bool adaptiveOk = true;
+    long long expectedSum = 0;
+    int lastB = adaptiveList.blockSize();
+    for (int i = 0; i < 300000; i++) {
+        adaptiveList.add(i);
+        expectedSum += i;
+        if (adaptiveList.blockSize() != lastB) {
+            std::cout << "n=" << adaptiveList.size() << ": b " << lastB
+                      << " -> " << adaptiveList.blockSize() << std::endl;
+            lastB = adaptiveList.blockSize();
+        }
+        if (adaptiveList.reblocking() && i % 64 == 0) {
+            // Mid-migration the list is still valid and iterates in order
+            adaptiveOk = adaptiveOk && adaptiveList.validate()
+                && std::accumulate(adaptiveList.begin(), adaptiveList.end(), 0LL) == expectedSum;
+        }
+    }
+    while (adaptiveList.size() > 1000) {
+        adaptiveList.remove(adaptiveList.size() / 2);
+    }
+    std::cout << "After shrinking to " << adaptiveList.size()
+              << " elements: b=" << adaptiveList.blockSize() << std::endl;
+    std::cout << ((adaptiveOk && adaptiveList.validate()) ? "✓" : "✗")
+              << " valid throughout re-blocking" << std::endl;
+
+    std::cout << "\n17. Range operations:" << std::endl;
+    SEList<int> rangeList(3);
+    for (int i = 0; i < 12; i++) {
+        rangeList.add(i);
+    }
+    std::vector<int> extra = {100, 101, 102, 103, 104, 105, 106};
+    rangeList.insert(5, extra.begin(), extra.end());
+    std::cout << "insert(5, 100..106): ";
+    rangeList.print();
+    rangeList.erase(3, 10);
+    std::cout << "erase(3, 10):        ";
+    rangeList.print();
+    SEList<int> back = rangeList.split(6);
+    std::cout << "split(6) left:       ";
+    rangeList.print();
+    std::cout << "split(6) right:      ";
+    back.print();
+    rangeList.splice(0, std::move(back));
+    std::cout << "splice(0, right):    ";
+    rangeList.print();
+    std::cout << ((rangeList.validate() && back.empty()) ? "✓" : "✗")
+              << " range operations keep the structure valid" << std::endl;
+
+    SEList<int> bigLeft(64);
+    for (int i = 0; i < 1000000; i++) {
+        bigLeft.add(i);
+    }
+    auto r0 = std::chrono::steady_clock::now();
+    SEList<int> bigRight = bigLeft.split(500001);
+    auto r1 = std::chrono::steady_clock::now();
+    bigLeft.splice(250000, std::move(bigRight));
+    auto r2 = std::chrono::steady_clock::now();
+    bigLeft.erase(100000, 900000);
+    auto r3 = std::chrono::steady_clock::now();
+    std::cout << "1M elements, b=64: split "
+              << std::chrono::duration<double, std::milli>(r1 - r0).count() << " ms, splice "
+              << std::chrono::duration<double, std::milli>(r2 - r1).count() << " ms, erase 800k "
+              << std::chrono::duration<double, std::milli>(r3 - r2).count() << " ms"
+              << (bigLeft.validate() && bigLeft.size() == 200000 ? "" : " (invalid!)") << std::endl;
+
+    // Request-scoped lists: node slabs and block buffers come from a
+    // monotonic arena that is released once per request
+    using PmrList = SEList<int, 0, std::pmr::polymorphic_allocator<int>>;
+    std::pmr::monotonic_buffer_resource arena(1 << 20);
+    long long batchSum = 0;
+    auto b0 = std::chrono::steady_clock::now();
+    for (int request = 0; request < 200; request++) {
+        for (int k = 0; k < 8; k++) {
+            SEList<int> list(8);
+            for (int i = 0; i < 2000; i++) list.add(i);
+            batchSum += list.get(1000);
+        }
+    }
+    auto b1 = std::chrono::steady_clock::now();
+    for (int request = 0; request < 200; request++) {
+        for (int k = 0; k < 8; k++) {
+            PmrList list(8, nullptr, &arena);
+            for (int i = 0; i < 2000; i++) list.add(i);
+            batchSum += list.get(1000);
+        }
+        arena.release();
+    }
+    auto b2 = std::chrono::steady_clock::now();
+    std::cout << "200 requests x 8 lists of 2000: heap "
+              << std::chrono::duration<double, std::milli>(b1 - b0).count() << " ms, arena "
+              << std::chrono::duration<double, std::milli>(b2 - b1).count() << " ms"
+              << (batchSum == 200LL * 8 * 1000 * 2 ? "" : " (wrong sum!)") << std::endl;
+
+    std::pmr::unsynchronized_pool_resource pool(&arena);
+    SEList<std::pmr::string, 0, std::pmr::polymorphic_allocator<std::pmr::string>> words(4, nullptr, &pool);
+    words.add("a string long enough to need its own buffer");
+    std::cout << ((words.validate() && words.begin()->get_allocator().resource() == &pool) ? "✓" : "✗")
+              << " pmr strings in the blocks use the list's pool" << std::endl;
     
     return 0;
 }
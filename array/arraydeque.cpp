@@ -2,93 +2,309 @@
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <cstring>
+#include <span>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
+// Shift k elements inside a power-of-two circular buffer by d slots
+// (|d| < capacity), starting at physical slot from.  Runs are cut at the wrap
+// points of the source and destination ranges, so a one-slot shift is at
+// most three contiguous moves; memmove when T is trivially copyable.
+// Moving up goes back to front, moving down front to back, so overlap is safe.
 template <typename T>
+void ringShift(T* a, int mask, int from, int k, int d) {
+    int cap = mask + 1;
+    if (d > 0) {
+        int se = (from + k) & mask;       // one past the last source slot
+        int de = (from + k + d) & mask;
+        while (k > 0) {
+            int sEnd = se == 0 ? cap : se;
+            int dEnd = de == 0 ? cap : de;
+            int run = std::min(k, std::min(sEnd, dEnd));
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                std::memmove(a + dEnd - run, a + sEnd - run, run * sizeof(T));
+            } else {
+                std::move_backward(a + sEnd - run, a + sEnd, a + dEnd);
+            }
+            se = (sEnd - run) & mask;
+            de = (dEnd - run) & mask;
+            k -= run;
+        }
+    } else {
+        int s = from & mask;
+        int t = (from + d) & mask;
+        while (k > 0) {
+            int run = std::min(k, std::min(cap - s, cap - t));
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                std::memmove(a + t, a + s, run * sizeof(T));
+            } else {
+                std::move(a + s, a + s + run, a + t);
+            }
+            s = (s + run) & mask;
+            t = (t + run) & mask;
+            k -= run;
+        }
+    }
+}
+
+// Move n elements from src into raw storage at dst and end the source
+// objects' lifetimes; a single memcpy when T is trivially copyable
+template <typename T>
+void relocate(T* src, int n, T* dst) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (n > 0) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+    } else {
+        for (int i = 0; i < n; ++i) {
+            ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+// Buffers come from Alloc and elements are constructed through it, so a
+// std::pmr::polymorphic_allocator keeps a whole queue in one resource.
+template <typename T, typename Alloc = std::allocator<T>>
 class Array {
 private:
-    T* a;
-    int length;  // total capacity
+    using Traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc;
+    T* a;        // raw storage, only the n slots from j on are constructed
+    int length;  // total capacity, always a power of two
+    int mask;    // length - 1, so index wrap is (i & mask)
     int n;       // current number of elements
     int j;       // start index (head)
 
-    void resize() {
+    // incremental-resize mode: once the array is half full a buffer of
+    // twice the size is allocated and every add/remove copies growRate
+    // more elements into it, so no single operation copies everything.
+    // Elements [0, copied) live in grown, the rest still in a.
+    static const int growRate = 3;
+    bool incremental = false;
+    T* grown = nullptr;
+    int grown_length = 0;
+    int grown_j = 0;     // head of grown
+    int copied = 0;      // elements already moved to grown
+    static inline bool verboseByDefault = true;
+    bool verbose = verboseByDefault;
+
+    static int roundUp(int len) {
+        int p = 1;
+        while (p < len) p *= 2;
+        return p;
+    }
+
+    T* allocate(int len) {
+        return Traits::allocate(alloc, len);
+    }
+    void deallocate(T* p, int len) {
+        if (p != nullptr) Traits::deallocate(alloc, p, len);
+    }
+
+    // construct an element in a raw slot
+    template <typename... Args>
+    void construct(T* p, Args&&... args) {
+        Traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    // destroy the live elements and release both buffers
+    void destroyAll() {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (int i = 0; i < n; ++i) slot(i).~T();
+        }
+        deallocate(a, length);
+        deallocate(grown, grown_length);
+    }
+
+    T& slot(int i) {
+        return i < copied ? grown[(grown_j + i) & (grown_length - 1)]
+                          : a[(j + i) & mask];
+    }
+    const T& slot(int i) const {
+        return i < copied ? grown[(grown_j + i) & (grown_length - 1)]
+                          : a[(j + i) & mask];
+    }
+
+    // switch over to grown once everything has been copied
+    void adoptGrown() {
         int old_length = length;
-        // double capacity (at least 1)
-        length = std::max(1, 2 * old_length);
-        T* new_a = new T[length];
+        deallocate(a, length);   // every element already moved out
+        a = grown;
+        length = grown_length;
+        mask = length - 1;
+        j = grown_j;
+        grown = nullptr;
+        grown_length = 0;
+        grown_j = 0;
+        copied = 0;
+        if (verbose) {
+            std::cout << "Resized from " << old_length
+                      << " to " << length << " (incremental)" << std::endl;
+        }
+    }
 
-        // copy elements in order from old buffer
-        for (int i = 0; i < n; ++i) {
-            new_a[i] = a[(j + i) % old_length];
+    void growStep() {
+        if (!incremental) return;
+        if (grown == nullptr) {
+            if (2 * n < length) return;
+            grown_length = 2 * length;
+            grown = allocate(grown_length);
+            grown_j = 0;
+            copied = 0;
+        }
+        for (int k = 0; k < growRate && copied < n; ++k, ++copied) {
+            relocate(&a[(j + copied) & mask], 1, &grown[(grown_j + copied) & (grown_length - 1)]);
         }
+        if (copied == n) adoptGrown();
+    }
+
+    void finishGrow() {
+        for (; copied < n; ++copied) {
+            relocate(&a[(j + copied) & mask], 1, &grown[(grown_j + copied) & (grown_length - 1)]);
+        }
+        adoptGrown();
+    }
 
-        delete[] a;
+    void resize(int need = 0) {
+        int old_length = length;
+        // double capacity (at least 1, and at least need)
+        length = std::max(roundUp(need), std::max(1, 2 * old_length));
+        mask = length - 1;
+        T* new_a = allocate(length);
+
+        // move elements in order from the old buffer, in at most two runs
+        int first = std::min(n, old_length - j);
+        relocate(a + j, first, new_a);
+        relocate(a, n - first, new_a + first);
+
+        deallocate(a, old_length);
         a = new_a;
         j = 0;
 
-        std::cout << "Resized from " << old_length
-                  << " to " << length << std::endl;
+        if (verbose) {
+            std::cout << "Resized from " << old_length
+                      << " to " << length << std::endl;
+        }
     }
 
 public:
     // ctor
-    Array(int len = 1)
-      : length(len), n(0), j(0), a(new T[len])
+    Array(int len = 1, const Alloc& alloc = Alloc())
+      : alloc(alloc), a(allocate(roundUp(len))), length(roundUp(len)), mask(length - 1), n(0), j(0)
     {
-        std::cout << "Created array of size " << length << std::endl;
+        if (verbose) std::cout << "Created array of size " << length << std::endl;
     }
 
     // dtor
     ~Array() {
-        delete[] a;
-        std::cout << "Destroyed array" << std::endl;
+        destroyAll();
+        if (verbose) std::cout << "Destroyed array" << std::endl;
     }
 
     // copy ctor
-    Array(const Array<T>& other)
-      : length(other.length),
+    Array(const Array& other)
+      : Array(other, Traits::select_on_container_copy_construction(other.alloc)) {}
+
+    // copy into storage from a given allocator
+    Array(const Array& other, const Alloc& alloc)
+      : alloc(alloc),
+        a(allocate(std::max(other.length, 1))),
+        length(std::max(other.length, 1)),
+        mask(length - 1),
         n(other.n),
-        j(0),                // we'll normalize head to 0
-        a(new T[other.length])
+        j(0)                 // we'll normalize head to 0
     {
         // copy in logical order
         for (int i = 0; i < n; ++i) {
-            a[i] = other.get(i);
+            construct(a + i, other.slot(i));
         }
-        std::cout << "Copied array" << std::endl;
+        if (verbose) std::cout << "Copied array" << std::endl;
     }
 
-    // copy assign
-    Array<T>& operator=(const Array<T>& other) {
+    // copy assign, keeps this array's allocator
+    Array& operator=(const Array& other) {
         if (this != &other) {
-            delete[] a;
-            length = other.length;
+            destroyAll();
+            grown  = nullptr;
+            grown_length = 0;
+            copied = 0;
+            length = std::max(other.length, 1);
+            mask   = length - 1;
             n      = other.n;
             j      = 0;
-            a      = new T[length];
+            a      = allocate(length);
             for (int i = 0; i < n; ++i) {
-                a[i] = other.get(i);
+                construct(a + i, other.slot(i));
             }
-            std::cout << "Copy assigned array" << std::endl;
+            if (verbose) std::cout << "Copy assigned array" << std::endl;
         }
         return *this;
     }
 
     // move assign
-    Array<T>& operator=(Array<T>&& other) noexcept {
+    Array& operator=(Array&& other) noexcept(Traits::is_always_equal::value) {
+        if (!Traits::is_always_equal::value && !(alloc == other.alloc)) {
+            // other's buffers belong to another allocator: move the elements
+            if (this != &other) {
+                destroyAll();
+                grown  = nullptr;
+                grown_length = 0;
+                copied = 0;
+                length = std::max(other.length, 1);
+                mask   = length - 1;
+                n      = other.n;
+                j      = 0;
+                a      = allocate(length);
+                for (int i = 0; i < n; ++i) {
+                    construct(a + i, std::move(other.slot(i)));
+                }
+                if (verbose) std::cout << "Moved array elements" << std::endl;
+            }
+            return *this;
+        }
         if (this != &other) {
-            delete[] a;
+            destroyAll();
             a       = other.a;
             length  = other.length;
+            mask    = other.mask;
             n       = other.n;
             j       = other.j;
+            incremental  = other.incremental;
+            grown        = other.grown;
+            grown_length = other.grown_length;
+            grown_j      = other.grown_j;
+            copied       = other.copied;
 
             other.a      = nullptr;
             other.length = 0;
+            other.mask   = 0;
             other.n      = 0;
             other.j      = 0;
+            other.grown  = nullptr;
+            other.grown_length = 0;
+            other.copied = 0;
 
-            std::cout << "Moved array ownership" << std::endl;
+            if (verbose) std::cout << "Moved array ownership" << std::endl;
         }
         return *this;
     }
@@ -97,72 +313,140 @@ public:
     int size() const     { return n;        }
     int capacity() const { return length;   }
     bool empty() const   { return n == 0;   }
+    Alloc get_allocator() const { return alloc; }
+
+    // incremental resizing keeps every push/pop at the ends O(1) worst case
+    void setIncremental(bool on) {
+        if (!on && grown != nullptr) finishGrow();
+        incremental = on;
+    }
+    bool isIncremental() const { return incremental; }
+
+    // turn the resize/lifecycle logging off for benchmarks
+    void setVerbose(bool on) { verbose = on; }
+    // for arrays created from now on, including their creation message
+    static void setVerboseByDefault(bool on) { verboseByDefault = on; }
 
     // random-access
     T& operator[](int i) {
         assert(i >= 0 && i < n);
-        return a[(j + i) % length];
+        return slot(i);
     }
     const T& operator[](int i) const {
         assert(i >= 0 && i < n);
-        return a[(j + i) % length];
+        return slot(i);
     }
 
     // get/set
     T get(int i) const {
         assert(i >= 0 && i < n);
-        return a[(j + i) % length];
+        return slot(i);
     }
     T set(int i, T x) {
         assert(i >= 0 && i < n);
-        int idx = (j + i) % length;
-        T old = a[idx];
-        a[idx] = x;
+        T old = std::move(slot(i));
+        slot(i) = std::move(x);
         return old;
     }
 
-    // insert at index i
-    void add(int i, T x) {
+    // construct an element in place at index i
+    template <typename... Args>
+    T& emplace(int i, Args&&... args) {
         assert(i >= 0 && i <= n);
-        if (n == length) resize();
+        if (grown == nullptr && n < length && (i == n || i == 0)) {
+            // an end with a free slot: build it where it goes
+            if (i == 0) j = (j - 1) & mask;
+            construct(&a[(j + i) & mask], std::forward<Args>(args)...);
+            ++n;
+            growStep();
+            return slot(i);
+        }
+        T x(std::forward<Args>(args)...);   // args may refer into the array
 
-        // choose the shorter shift
-        if (i < n/2) {
-            // shift frontward: increment j backwards
-            j = (j == 0 ? length-1 : j-1);
-            for (int k = 0; k < i; ++k) {
-                a[(j + k) % length] = a[(j + k + 1) % length];
-            }
-        } else {
-            // shift backward: move tail forward
-            for (int k = n; k > i; --k) {
-                a[(j + k) % length] = a[(j + k - 1) % length];
+        // a grow in progress only supports the two ends incrementally
+        if (grown != nullptr && i != 0 && i != n) finishGrow();
+        if (n == length) {
+            if (grown != nullptr) finishGrow();
+            else resize();
+        }
+
+        if (grown != nullptr) {
+            if (i == 0) {
+                // new head goes straight into the grown buffer
+                j = (j - 1) & mask;
+                grown_j = (grown_j - 1) & (grown_length - 1);
+                construct(&grown[grown_j], std::move(x));
+                ++copied;
+            } else {
+                construct(&a[(j + n) & mask], std::move(x));
             }
+            ++n;
+            growStep();
+            return slot(i);
         }
 
-        a[(j + i) % length] = x;
+        // choose the shorter shift; the slot it moves into is raw, so that
+        // one element is move-constructed and the rest move-assigned
+        if (i == 0 || i == n) {
+            if (i == 0) j = (j - 1) & mask;
+            construct(&a[(j + i) & mask], std::move(x));
+        } else if (i < n/2) {
+            // shift the prefix one slot toward the front
+            construct(&a[(j - 1) & mask], std::move(a[j]));
+            ringShift(a, mask, (j + 1) & mask, i - 1, -1);
+            j = (j - 1) & mask;
+            a[(j + i) & mask] = std::move(x);
+        } else {
+            // shift the suffix one slot toward the back
+            construct(&a[(j + n) & mask], std::move(a[(j + n - 1) & mask]));
+            ringShift(a, mask, (j + i) & mask, n - i - 1, 1);
+            a[(j + i) & mask] = std::move(x);
+        }
         ++n;
+        growStep();
+        return slot(i);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return emplace(n, std::forward<Args>(args)...);
+    }
+
+    // insert at index i
+    void add(int i, T x) {
+        emplace(i, std::move(x));
     }
 
     // remove at index i
     T remove(int i) {
         assert(i >= 0 && i < n);
-        int idx = (j + i) % length;
-        T val = a[idx];
+        if (grown != nullptr && i != 0 && i != n-1) finishGrow();
 
-        if (i < n/2) {
-            // shift the prefix right
-            for (int k = i; k > 0; --k) {
-                a[(j + k) % length]
-                  = a[(j + k - 1) % length];
+        if (grown != nullptr) {
+            T val = std::move(slot(i));
+            slot(i).~T();
+            if (i == 0) {
+                j = (j + 1) & mask;
+                grown_j = (grown_j + 1) & (grown_length - 1);
             }
-            j = (j + 1) % length;
+            if (i < copied) --copied;
+            --n;
+            growStep();
+            return val;
+        }
+
+        int idx = (j + i) & mask;
+        T val = std::move(a[idx]);
+
+        if (i < n/2) {
+            // shift the prefix right, the old head slot is left over
+            ringShift(a, mask, j, i, 1);
+            a[j].~T();
+            j = (j + 1) & mask;
         } else {
-            // shift the suffix left
-            for (int k = i; k < n-1; ++k) {
-                a[(j + k) % length]
-                  = a[(j + k + 1) % length];
-            }
+            // shift the suffix left, the old tail slot is left over
+            ringShift(a, mask, (idx + 1) & mask, n - 1 - i, -1);
+            a[(j + n - 1) & mask].~T();
         }
 
         --n;
@@ -170,9 +454,98 @@ public:
     }
 
     // queue‐style helpers
-    void push_back(T x) { add(n, x);          }
+    void push_back(T x) { emplace(n, std::move(x)); }
     T pop_front()       { return remove(0);   }
 
+    // The contents as at most two contiguous runs, front first; the second
+    // is empty unless the contents wrap.  Finishes a pending incremental
+    // grow so everything lives in one buffer.  Invalidated by any add/remove.
+    std::array<std::span<T>, 2> front_spans() {
+        if (grown != nullptr) finishGrow();
+        int first = std::min(n, length - j);
+        return { std::span<T>(a + j, first), std::span<T>(a, n - first) };
+    }
+
+    // append k elements with at most two bulk copies
+    void push_back_n(const T* src, int k) {
+        assert(k >= 0);
+        if (grown != nullptr) finishGrow();
+        if (n + k > length) resize(n + k);
+        int p = (j + n) & mask;
+        int first = std::min(k, length - p);
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::uninitialized_copy(src, src + first, a + p);
+            std::uninitialized_copy(src + first, src + k, a);
+        } else {
+            for (int i = 0; i < k; ++i) construct(&a[(p + i) & mask], src[i]);
+        }
+        n += k;
+        growStep();
+    }
+
+    // move up to k elements from the front into dst, returns how many
+    int pop_front_n(T* dst, int k) {
+        k = std::min(k, n);
+        if (grown != nullptr) finishGrow();
+        int first = std::min(k, length - j);
+        std::move(a + j, a + j + first, dst);
+        std::move(a, a + (k - first), dst + first);
+        consume(k);
+        return k;
+    }
+
+    // Read up to max bytes from fd straight into the free space (one or two
+    // segments, one readv).  Grows first if the buffer is full, so there is
+    // always room.  Returns what read(2) would: bytes read, 0 only at end of
+    // file, -1 with errno set.  max == 0 is rejected with -1 and ENOBUFS so
+    // 0 stays unambiguous.
+    ssize_t read_from(int fd, size_t max) {
+        static_assert(sizeof(T) == 1, "read_from needs a byte buffer");
+        if (max == 0) {
+            errno = ENOBUFS;
+            return -1;
+        }
+        if (grown != nullptr) finishGrow();
+        if (n == length) resize();
+        int p = (j + n) & mask;
+        size_t room = std::min(max, (size_t)(length - n));
+        size_t first = std::min(room, (size_t)(length - p));
+        iovec iov[2] = {{a + p, first}, {a, room - first}};
+        ssize_t got = readv(fd, iov, room > first ? 2 : 1);
+        if (got > 0) {
+            n += (int)got;
+            growStep();
+        }
+        return got;
+    }
+
+    // Write up to max bytes from the front to fd with one writev and drop
+    // whatever was written.  Returns bytes written or -1 with errno set.
+    ssize_t write_to(int fd, size_t max) {
+        static_assert(sizeof(T) == 1, "write_to needs a byte buffer");
+        auto spans = front_spans();
+        size_t first = std::min(max, spans[0].size());
+        size_t second = std::min(max - first, spans[1].size());
+        iovec iov[2] = {{spans[0].data(), first}, {spans[1].data(), second}};
+        ssize_t put = writev(fd, iov, second > 0 ? 2 : 1);
+        if (put > 0) consume((int)put);
+        return put;
+    }
+
+    // drop the first k elements, e.g. after reading them via front_spans()
+    void consume(int k) {
+        assert(k >= 0 && k <= n);
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (int i = 0; i < k; ++i) slot(i).~T();
+        }
+        if (grown != nullptr) {
+            grown_j = (grown_j + k) & (grown_length - 1);
+            copied = std::max(0, copied - k);
+        }
+        j = (j + k) & mask;
+        n -= k;
+    }
+
     // debug print
     void print() const {
         std::cout << "[";
@@ -184,7 +557,805 @@ public:
     }
 };
 
-int main() {
+// Single-producer/single-consumer ring with the same head + offset layout as
+// Array, but a fixed power-of-two capacity so wrapping is a mask instead of
+// a modulo.  head and tail are free-running counters, each on its own cache
+// line next to the owning thread's cached copy of the other counter; the
+// shared counter is only re-read when the cached one says full (or empty).
+template <typename T>
+class SpscRing {
+private:
+    static const int cacheLine = 64;
+
+    T* a;
+    size_t length;   // capacity, power of two
+    size_t mask;
+
+    alignas(cacheLine) std::atomic<size_t> tail{0};  // written by producer
+    size_t cachedHead = 0;                            // producer's view of head
+    alignas(cacheLine) std::atomic<size_t> head{0};  // written by consumer
+    size_t cachedTail = 0;                            // consumer's view of tail
+
+public:
+    SpscRing(size_t len = 1024) : length(1) {
+        while (length < len) length <<= 1;
+        mask = length - 1;
+        a = new T[length];
+    }
+    ~SpscRing() { delete[] a; }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return length; }
+    // exact only when called from one of the two endpoints while the other is idle
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+    // producer side
+    bool try_push(const T& x) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == length) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == length) return false;
+        }
+        a[t & mask] = x;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // push up to k elements from src, returns how many went in
+    size_t try_push_n(const T* src, size_t k) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t room = length - (t - cachedHead);
+        if (room < k) {
+            cachedHead = head.load(std::memory_order_acquire);
+            room = length - (t - cachedHead);
+        }
+        k = std::min(k, room);
+        if (k == 0) return 0;
+        // at most two contiguous runs: up to the end of the buffer, then from 0
+        size_t p = t & mask;
+        size_t first = std::min(k, length - p);
+        std::copy(src, src + first, a + p);
+        std::copy(src + first, src + k, a);
+        tail.store(t + k, std::memory_order_release);
+        return k;
+    }
+
+    // consumer side
+    bool try_pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        out = std::move(a[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // pop up to k elements into dst, returns how many came out
+    size_t try_pop_n(T* dst, size_t k) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t avail = cachedTail - h;
+        if (avail < k) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            avail = cachedTail - h;
+        }
+        k = std::min(k, avail);
+        if (k == 0) return 0;
+        size_t p = h & mask;
+        size_t first = std::min(k, length - p);
+        std::move(a + p, a + p + first, dst);
+        std::move(a, a + (k - first), dst + first);
+        head.store(h + k, std::memory_order_release);
+        return k;
+    }
+};
+
+// Array behind a mutex, bounded to its initial capacity so it never resizes;
+// this is how the ingest -> worker hand-off looked before SpscRing
+template <typename T>
+class LockedArray {
+private:
+    std::mutex m;
+    Array<T> q;
+    int cap;
+
+public:
+    LockedArray(int len) : q(len), cap(len) { q.setVerbose(false); }
+
+    bool try_push(const T& x) {
+        std::lock_guard<std::mutex> lock(m);
+        if (q.size() == cap) return false;
+        q.push_back(x);
+        return true;
+    }
+    bool try_pop(T& out) {
+        std::lock_guard<std::mutex> lock(m);
+        if (q.empty()) return false;
+        out = q.pop_front();
+        return true;
+    }
+    size_t try_push_n(const T* src, size_t k) {
+        std::lock_guard<std::mutex> lock(m);
+        k = std::min(k, (size_t)(cap - q.size()));
+        for (size_t i = 0; i < k; ++i) q.push_back(src[i]);
+        return k;
+    }
+    size_t try_pop_n(T* dst, size_t k) {
+        std::lock_guard<std::mutex> lock(m);
+        k = std::min(k, (size_t)q.size());
+        for (size_t i = 0; i < k; ++i) dst[i] = q.pop_front();
+        return k;
+    }
+};
+
+// Producer/consumer throughput: one thread pushes 0..items-1, the other pops
+// and checks the order.  batch > 1 uses try_push_n/try_pop_n.
+template <typename Queue>
+double queueThroughput(Queue& q, long long items, size_t batch) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        std::vector<long long> buf(batch);
+        long long next = 0;
+        while (next < items) {
+            if (batch == 1) {
+                if (q.try_push(next)) ++next;
+                else std::this_thread::yield();
+                continue;
+            }
+            size_t k = (size_t)std::min<long long>(batch, items - next);
+            for (size_t i = 0; i < k; ++i) buf[i] = next + (long long)i;
+            size_t done = 0;
+            while (done < k) {
+                size_t got = q.try_push_n(buf.data() + done, k - done);
+                if (got == 0) std::this_thread::yield();
+                done += got;
+            }
+            next += (long long)k;
+        }
+    });
+    std::vector<long long> buf(batch);
+    long long expect = 0;
+    while (expect < items) {
+        if (batch == 1) {
+            long long x;
+            if (q.try_pop(x)) {
+                assert(x == expect);
+                ++expect;
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        size_t k = q.try_pop_n(buf.data(), batch);
+        if (k == 0) std::this_thread::yield();
+        for (size_t i = 0; i < k; ++i) {
+            assert(buf[i] == expect);
+            ++expect;
+        }
+    }
+    producer.join();
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    return items / secs / 1e6;
+}
+
+// Round-trip latency: the main thread sends a value through one queue, an
+// echo thread sends it back through another.  Waits yield, so on a machine
+// with fewer than two cores this mostly measures the scheduler.
+template <typename Queue>
+void queuePingPong(Queue& there, Queue& back, int rounds, const char* label) {
+    std::thread echo([&] {
+        for (int i = 0; i < rounds; ++i) {
+            long long x;
+            while (!there.try_pop(x)) std::this_thread::yield();
+            while (!back.try_push(x)) std::this_thread::yield();
+        }
+    });
+    std::vector<long long> samples;
+    samples.reserve(rounds);
+    for (int i = 0; i < rounds; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        while (!there.try_push(i)) std::this_thread::yield();
+        long long x;
+        while (!back.try_pop(x)) std::this_thread::yield();
+        auto t1 = std::chrono::steady_clock::now();
+        assert(x == i);
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    echo.join();
+    std::sort(samples.begin(), samples.end());
+    std::cout << label << "  round trip p50=" << samples[rounds / 2]
+              << "ns  p99=" << samples[rounds * 99LL / 100] << "ns\n";
+}
+
+// Spin a few times, then yield, then sleep: blocking waits stay cheap when
+// the queue is only briefly full/empty without burning a core when it stays so
+class Backoff {
+private:
+    int step = 0;
+
+public:
+    void pause() {
+        if (step < 4) {
+            ++step;
+        } else if (step < 64) {
+            ++step;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+};
+
+// Bounded multi-producer/multi-consumer queue (Vyukov).  Same masked ring
+// indexing as SpscRing, but every slot carries a sequence number saying whose
+// turn it is: seq == pos means free for the producer that claims pos,
+// seq == pos+1 means filled for the consumer that claims pos.  Producers and
+// consumers claim positions with a CAS on tail/head, so no lock is needed.
+template <typename T>
+class MpmcQueue {
+private:
+    static const int cacheLine = 64;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    Cell* cells;
+    size_t length;   // capacity, power of two and at least 2
+    size_t mask;
+
+    alignas(cacheLine) std::atomic<size_t> tail{0};  // next position to fill
+    alignas(cacheLine) std::atomic<size_t> head{0};  // next position to drain
+
+public:
+    MpmcQueue(size_t len = 1024) : length(2) {
+        while (length < len) length <<= 1;
+        mask = length - 1;
+        cells = new Cell[length];
+        for (size_t i = 0; i < length; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MpmcQueue() { delete[] cells; }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t capacity() const { return length; }
+    // only a snapshot while other threads are running
+    size_t size() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    bool try_push(const T& x) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells[pos & mask];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;   // slot still holds the element from one lap ago: full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        c->data = x;
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells[pos & mask];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (dif == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;   // producer for pos has not finished: empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(c->data);
+        // hand the slot to the producer one lap ahead
+        c->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // blocking variants
+    void push(const T& x) {
+        Backoff backoff;
+        while (!try_push(x)) backoff.pause();
+    }
+    T pop() {
+        T out;
+        Backoff backoff;
+        while (!try_pop(out)) backoff.pause();
+        return out;
+    }
+
+    // timed variants: give up once the timeout has passed
+    template <typename Rep, typename Period>
+    bool try_push_for(const T& x, std::chrono::duration<Rep, Period> timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        Backoff backoff;
+        while (!try_push(x)) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            backoff.pause();
+        }
+        return true;
+    }
+    template <typename Rep, typename Period>
+    bool try_pop_for(T& out, std::chrono::duration<Rep, Period> timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        Backoff backoff;
+        while (!try_pop(out)) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            backoff.pause();
+        }
+        return true;
+    }
+};
+
+// producers x consumers throughput with blocking push/pop; every value
+// 0..items-1 is pushed once and the consumers' sums must add up
+double mpmcThroughput(int producers, int consumers, long long items) {
+    MpmcQueue<long long> q(1024);
+    std::atomic<long long> sum{0};
+    std::vector<std::thread> threads;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (long long x = p; x < items; x += producers) q.push(x);
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        long long share = items / consumers + (c < items % consumers ? 1 : 0);
+        threads.emplace_back([&, share] {
+            long long local = 0;
+            for (long long i = 0; i < share; ++i) local += q.pop();
+            sum += local;
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto t1 = std::chrono::steady_clock::now();
+    assert(sum == items * (items - 1) / 2);
+    (void)sum;
+    return items / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+// Chase-Lev work-stealing deque: the owner pushes and pops at the bottom,
+// thieves steal from the top.  Storage is the same doubling circular buffer
+// as Array/ArrayDeque, indexed by free-running top/bottom counters through a
+// mask.  Slots are atomics, so T must be trivially copyable (task pointers).
+// A thief may still be reading the old buffer after the owner grows, so old
+// buffers are retired rather than freed and only deleted with the deque;
+// since each is half the size of the next they never add up to more than
+// the live buffer.
+template <typename T>
+class WorkStealingDeque {
+private:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "WorkStealingDeque stores elements in atomics");
+    static const int cacheLine = 64;
+
+    struct Ring {
+        size_t length;   // power of two
+        size_t mask;
+        std::atomic<T>* a;
+
+        Ring(size_t len) : length(len), mask(len - 1), a(new std::atomic<T>[len]) {}
+        ~Ring() { delete[] a; }
+
+        T get(int64_t i) const { return a[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T x) { a[i & mask].store(x, std::memory_order_relaxed); }
+
+        Ring* grow(int64_t t, int64_t b) const {
+            Ring* r = new Ring(2 * length);
+            for (int64_t i = t; i < b; ++i) r->put(i, get(i));
+            return r;
+        }
+    };
+
+    alignas(cacheLine) std::atomic<int64_t> top{0};     // thieves' end
+    alignas(cacheLine) std::atomic<int64_t> bottom{0};  // owner's end
+    alignas(cacheLine) std::atomic<Ring*> ring;
+    std::vector<Ring*> retired;   // owner only
+
+public:
+    WorkStealingDeque(size_t len = 64) {
+        size_t length = 1;
+        while (length < len) length <<= 1;
+        ring.store(new Ring(length), std::memory_order_relaxed);
+    }
+    ~WorkStealingDeque() {
+        delete ring.load(std::memory_order_relaxed);
+        for (Ring* r : retired) delete r;
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // only a snapshot while thieves are running
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? (size_t)(b - t) : 0;
+    }
+    size_t capacity() const { return ring.load(std::memory_order_relaxed)->length; }
+
+    // owner only
+    void push(T x) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > (int64_t)r->mask) {
+            Ring* bigger = r->grow(t, b);
+            retired.push_back(r);
+            ring.store(bigger, std::memory_order_release);
+            r = bigger;
+        }
+        r->put(b, x);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // owner only; LIFO end
+    bool pop(T& out) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            // was empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = r->get(b);
+        if (t < b) return true;
+        // last element: race the thieves for it
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // any thread; FIFO end
+    bool steal(T& out) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        Ring* r = ring.load(std::memory_order_acquire);
+        T x = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return false;   // lost to the owner or another thief
+        }
+        out = x;
+        return true;
+    }
+};
+
+// Fork-join thread pool: each worker owns a WorkStealingDeque of tasks,
+// spawns from a worker go to its own deque, spawns from outside go through
+// an MpmcQueue.  Idle workers steal from a random victim.  waitUntil() runs
+// tasks while it waits, so joining inside a task does not block a worker.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    MpmcQueue<Task*> injected;
+    std::atomic<bool> stopping{false};
+
+    inline static thread_local WorkStealingPool* current = nullptr;
+    inline static thread_local int self = -1;
+    inline static thread_local unsigned rng = 0x9e3779b9u;
+
+    int me() const { return current == this ? self : -1; }
+
+    bool runOne() {
+        int w = me();
+        Task* t = nullptr;
+        bool found = (w >= 0 && workers[w]->deque.pop(t)) || injected.try_pop(t);
+        if (!found) {
+            int k = (int)workers.size();
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            int start = (int)(rng % (unsigned)k);
+            for (int i = 0; i < k && !found; ++i) {
+                int v = (start + i) % k;
+                if (v != w) found = workers[v]->deque.steal(t);
+            }
+        }
+        if (!found) return false;
+        (*t)();
+        delete t;
+        return true;
+    }
+
+    void loop(int w) {
+        current = this;
+        self = w;
+        rng += (unsigned)w * 2654435761u;
+        Backoff backoff;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (runOne()) backoff = Backoff();
+            else backoff.pause();
+        }
+    }
+
+public:
+    WorkStealingPool(int nthreads) : injected(1024) {
+        nthreads = std::max(1, nthreads);
+        for (int i = 0; i < nthreads; ++i) workers.emplace_back(new Worker);
+        for (int i = 0; i < nthreads; ++i) threads.emplace_back(&WorkStealingPool::loop, this, i);
+    }
+
+    ~WorkStealingPool() {
+        stopping.store(true, std::memory_order_release);
+        for (auto& t : threads) t.join();
+        Task* t;
+        for (auto& w : workers) while (w->deque.pop(t)) delete t;
+        while (injected.try_pop(t)) delete t;
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return (int)workers.size(); }
+
+    void spawn(Task fn) {
+        Task* t = new Task(std::move(fn));
+        int w = me();
+        if (w >= 0) workers[w]->deque.push(t);
+        else        injected.push(t);
+    }
+
+    template <typename Pred>
+    void waitUntil(Pred done) {
+        Backoff backoff;
+        while (!done()) {
+            if (runOne()) backoff = Backoff();
+            else backoff.pause();
+        }
+    }
+};
+
+long long serialFib(int n) {
+    return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+}
+
+// fork-join fib: spawn one half, compute the other, help until the spawned
+// half is done; below cutoff just run serially
+long long parallelFib(WorkStealingPool& pool, int n, int cutoff) {
+    if (n < cutoff) return serialFib(n);
+    long long a = 0;
+    std::atomic<bool> done{false};
+    pool.spawn([&] {
+        a = parallelFib(pool, n - 1, cutoff);
+        done.store(true, std::memory_order_release);
+    });
+    long long b = parallelFib(pool, n - 2, cutoff);
+    pool.waitUntil([&] { return done.load(std::memory_order_acquire); });
+    return a + b;
+}
+
+// Mid-sequence insert/erase cost: each add/remove near the middle shifts
+// about n/2 elements, reported as shifted bytes per second
+void midShiftBandwidth(int n, int ops) {
+    Array<int> q(n);
+    q.setVerbose(false);
+    for (int i = 0; i < n; ++i) q.push_back(i);
+    // rotate the head so the shifts cross the wrap point
+    for (int i = 0; i < n / 3; ++i) q.push_back(q.pop_front());
+    auto t0 = std::chrono::steady_clock::now();
+    long long sink = 0;
+    for (int k = 0; k < ops; ++k) {
+        int i = n / 2 - 1 - (k % 7);
+        q.add(i, k);
+        sink += q.remove(i + 1);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double bytes = 2.0 * ops * (n / 2) * sizeof(int);
+    std::cout << "n=" << n << "  " << secs / (2.0 * ops) * 1e9 << " ns/op  "
+              << bytes / secs / 1e9 << " GB/s shifted  (" << (sink & 1) << ")\n";
+}
+
+// Drain a queue of ints one pop_front() at a time vs. reading front_spans()
+// and consume()-ing, with a producer appending batches via push_back_n
+void batchedDrain(int total, int batch) {
+    std::vector<int> src(batch);
+    for (int i = 0; i < batch; ++i) src[i] = i;
+    for (int mode = 0; mode < 2; ++mode) {
+        Array<int> q(1024);
+        q.setVerbose(false);
+        long long sum = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int done = 0; done < total; done += batch) {
+            q.push_back_n(src.data(), batch);
+            if (mode == 0) {
+                for (int i = 0; i < batch; ++i) sum += q.pop_front();
+            } else {
+                for (auto part : q.front_spans()) {
+                    for (int x : part) sum += x;
+                }
+                q.consume(q.size());
+            }
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << (mode == 0 ? "pop_front          " : "front_spans/consume")
+                  << "  " << total / secs / 1e6 << " M items/s  (sum " << sum << ")\n";
+    }
+}
+
+// Pipe a file through a byte Array into /dev/null with read_from/write_to,
+// against the read-into-a-temporary-then-push_back-byte-by-byte loop.
+// total counts bytes written; a read or write error stops the run and is
+// reported instead of a rate.
+void streamFile(const char* path, int bufSize) {
+    int out = open("/dev/null", O_WRONLY);
+    if (out < 0) { std::perror("/dev/null"); return; }
+    for (int mode = 0; mode < 2; ++mode) {
+        int in = open(path, O_RDONLY);
+        if (in < 0) { std::perror(path); break; }
+        Array<char> q(bufSize);
+        q.setVerbose(false);
+        std::vector<char> tmp(bufSize / 2);
+        long long total = 0;
+        const char* failed = nullptr;   // the call that failed, with err
+        int err = 0;
+        // the byte-by-byte loop only gets the first 32 MB, it is slow
+        long long limit = mode == 0 ? (32LL << 20) : -1;
+        auto t0 = std::chrono::steady_clock::now();
+        while (failed == nullptr) {
+            if (mode == 0) {
+                if (limit >= 0 && total >= limit) break;
+                ssize_t got = read(in, tmp.data(), tmp.size());
+                if (got < 0 && errno == EINTR) continue;
+                if (got < 0) { failed = "read"; err = errno; break; }
+                if (got == 0) break;
+                for (ssize_t i = 0; i < got; ++i) q.push_back(tmp[i]);
+                for (ssize_t i = 0; i < got; ++i) tmp[i] = q.pop_front();
+                if (write(out, tmp.data(), got) != got) { failed = "write"; err = errno; break; }
+                total += got;
+            } else {
+                ssize_t got = q.read_from(in, bufSize / 2);
+                if (got < 0 && errno == EINTR) continue;
+                if (got < 0) { failed = "read"; err = errno; break; }
+                if (got == 0) break;
+                while (q.size() > 0) {
+                    ssize_t put = q.write_to(out, q.size());
+                    if (put < 0 && errno == EINTR) continue;
+                    if (put < 0) { failed = "write"; err = errno; break; }
+                    total += put;
+                }
+            }
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        const char* label = mode == 0 ? "read + push_back/pop_front" : "read_from/write_to        ";
+        if (failed != nullptr) {
+            std::cout << label << "  " << failed << " failed after " << total / 1e9
+                      << " GB: " << std::strerror(err) << "\n";
+        } else {
+            std::cout << label << "  " << total / 1e9 << " GB in " << secs << " s = "
+                      << total / secs / 1e9 << " GB/s\n";
+        }
+        close(in);
+    }
+    close(out);
+}
+
+// Write a scratch file of the given size for streamFile, returns its path
+std::string makeScratchFile(long long bytes) {
+    char path[] = "/tmp/arraydeque-streamXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) { std::perror("mkstemp"); return ""; }
+    std::vector<char> block(1 << 20);
+    for (size_t i = 0; i < block.size(); ++i) block[i] = (char)(i * 31);
+    for (long long done = 0; done < bytes; done += (long long)block.size()) {
+        if (write(fd, block.data(), block.size()) != (ssize_t)block.size()) {
+            std::perror("write");
+            break;
+        }
+    }
+    close(fd);
+    return path;
+}
+
+// Per-operation latency of a growing queue (two push_backs per pop_front),
+// bucketed by powers of two in nanoseconds
+void latencyHistogram(bool incremental, int ops) {
+    Array<int> q(1);
+    q.setVerbose(false);
+    q.setIncremental(incremental);
+    std::vector<long long> samples;
+    samples.reserve(ops);
+    for (int i = 0; i < ops; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (i % 3 == 2) q.pop_front();
+        else            q.push_back(i);
+        auto t1 = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    std::vector<long long> buckets(40, 0);
+    for (long long ns : samples) {
+        int b = 0;
+        while ((2LL << b) <= ns) ++b;
+        ++buckets[b];
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << (incremental ? "incremental" : "doubling   ")
+              << "  p50=" << samples[ops / 2]
+              << "ns  p99=" << samples[ops * 99LL / 100]
+              << "ns  p99.9=" << samples[ops * 999LL / 1000]
+              << "ns  max=" << samples.back() << "ns\n";
+    for (int b = 0; b < 40; ++b) {
+        if (buckets[b] == 0) continue;
+        std::cout << "    <" << (2LL << b) << "ns: " << buckets[b] << '\n';
+    }
+}
+
+// Request-scoped batches: each request builds a few string queues and
+// throws them away.  Default heap versus a per-request monotonic arena,
+// which hands out memory by bumping a pointer and frees it all at once.
+void arenaBatch(int requests, int queues, int items) {
+    const char* word = "a payload string that does not fit in the SSO buffer";
+    using PmrArray = Array<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+    Array<std::string>::setVerboseByDefault(false);
+    PmrArray::setVerboseByDefault(false);
+    long long sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+        for (int k = 0; k < queues; ++k) {
+            Array<std::string> q(1);
+            for (int i = 0; i < items; ++i) q.emplace_back(word);
+            sum += q.pop_front().size();
+        }
+    }
+    double heap = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::pmr::monotonic_buffer_resource arena(1 << 20);
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+        for (int k = 0; k < queues; ++k) {
+            PmrArray q(1, &arena);
+            for (int i = 0; i < items; ++i) q.emplace_back(word);
+            sum += q.pop_front().size();
+        }
+        arena.release();   // the whole request in one call
+    }
+    double pooled = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    Array<std::string>::setVerboseByDefault(true);
+    PmrArray::setVerboseByDefault(true);
+    std::cout << "heap " << heap * 1e3 << " ms, arena " << pooled * 1e3
+              << " ms  (" << (sum & 1) << ")\n";
+}
+
+int main(int argc, char** argv) {
     std::cout << "--- Initial Push ---\n";
     Array<int> arr(2); // Small initial size to trigger resizing
     arr.push_back(10);
@@ -245,6 +1416,115 @@ int main() {
     moved.print();        // [42, 43]
     std::cout << "assign.size(): " << assign.size() << '\n'; // Should be 0
 
+    std::cout << "\n--- Batched push/pop and span views ---\n";
+    {
+        Array<int> q(8);
+        int in[] = {1, 2, 3, 4, 5, 6};
+        q.push_back_n(in, 6);
+        int out[4];
+        std::cout << "pop_front_n(4): " << q.pop_front_n(out, 4)
+                  << " -> " << out[0] << ' ' << out[1] << ' ' << out[2] << ' ' << out[3] << '\n';
+        q.push_back_n(in, 6);   // wraps past the end of the buffer
+        auto spans = q.front_spans();
+        std::cout << "front_spans sizes: " << spans[0].size() << " + " << spans[1].size() << '\n';
+        q.consume(3);
+        q.print();
+    }
+    batchedDrain(20000000, 256);
+
+    std::cout << "\n--- Scatter-gather file streaming ---\n";
+    if (argc > 1) {
+        // stream a file given on the command line, e.g. a multi-GB one
+        streamFile(argv[1], 1 << 20);
+    } else {
+        // 64 MB by default; SCRATCH_MB=1024 for a longer run
+        long long mb = 64;
+        if (const char* env = std::getenv("SCRATCH_MB")) mb = std::max(1LL, std::atoll(env));
+        std::string path = makeScratchFile(mb << 20);
+        if (!path.empty()) {
+            streamFile(path.c_str(), 1 << 20);
+            unlink(path.c_str());
+        }
+    }
+
+    std::cout << "\n--- Mid-sequence insert/erase (segmented memmove shift) ---\n";
+    midShiftBandwidth(1 << 12, 200000);
+    midShiftBandwidth(1 << 20, 400);
+
+    std::cout << "\n--- Latency histogram: doubling vs incremental resize ---\n";
+    latencyHistogram(false, 3000000);
+    latencyHistogram(true, 3000000);
+
+    std::cout << "\n--- Request-scoped string queues: heap vs arena ---\n";
+    arenaBatch(2000, 16, 64);
+
+    std::cout << "\n--- SPSC ring vs mutex-wrapped Array ---\n";
+    {
+        const long long items = 5000000;
+        LockedArray<long long> locked(1024), lockedBatched(1024);
+        SpscRing<long long> ring(1024);
+        SpscRing<long long> batched(1024);
+        std::cout << "mutex Array      " << queueThroughput(locked, items, 1) << " M items/s\n";
+        std::cout << "mutex Array x64  " << queueThroughput(lockedBatched, items, 64) << " M items/s\n";
+        std::cout << "spsc try_push    " << queueThroughput(ring, items, 1) << " M items/s\n";
+        std::cout << "spsc try_push_n  " << queueThroughput(batched, items, 64) << " M items/s\n";
+
+        LockedArray<long long> l1(64), l2(64);
+        SpscRing<long long> r1(64), r2(64);
+        queuePingPong(l1, l2, 100000, "mutex Array");
+        queuePingPong(r1, r2, 100000, "spsc ring  ");
+    }
+
+    std::cout << "\n--- Bounded MPMC queue ---\n";
+    {
+        MpmcQueue<int> q(4);
+        for (int i = 0; i < 4; ++i) q.push(i);
+        std::cout << "full, try_push: " << q.try_push(99)
+                  << ", try_push_for(1ms): " << q.try_push_for(99, std::chrono::milliseconds(1)) << '\n';
+        std::cout << "pop: " << q.pop() << ' ' << q.pop() << ' ' << q.pop() << ' ' << q.pop() << '\n';
+        int x;
+        std::cout << "empty, try_pop_for(1ms): " << q.try_pop_for(x, std::chrono::milliseconds(1)) << '\n';
+
+        unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+        std::cout << "throughput, M items/s (producers x consumers, " << hw << " hw threads)\n";
+        for (int p = 1; p <= (int)hw && p <= 8; p *= 2) {
+            for (int c = 1; c <= (int)hw && c <= 8; c *= 2) {
+                std::cout << "  " << p << "x" << c << ": " << mpmcThroughput(p, c, 1000000) << '\n';
+            }
+        }
+    }
+
+    std::cout << "\n--- Work-stealing deque and fork-join pool ---\n";
+    {
+        WorkStealingDeque<int> d(2);
+        for (int i = 0; i < 5; ++i) d.push(i);   // grows 2 -> 4 -> 8
+        int x = -1;
+        d.steal(x);
+        std::cout << "capacity " << d.capacity() << ", stole " << x;
+        d.pop(x);
+        std::cout << ", popped " << x << ", size " << d.size() << '\n';
+
+        const int n = 36, cutoff = 20;
+        auto t0 = std::chrono::steady_clock::now();
+        long long expect = serialFib(n);
+        double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "fib(" << n << ") serial: " << serial * 1e3 << " ms\n";
+        int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> counts;
+        for (int k = 1; k < hw; k *= 2) counts.push_back(k);
+        counts.push_back(hw);
+        for (int k : counts) {
+            WorkStealingPool pool(k);
+            t0 = std::chrono::steady_clock::now();
+            long long got = parallelFib(pool, n, cutoff);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            assert(got == expect);
+            (void)got;
+            std::cout << "  " << k << " workers: " << secs * 1e3 << " ms, speedup "
+                      << serial / secs << "x\n";
+        }
+    }
+
     std::cout << "\n--- Done ---\n";
     return 0;
 }
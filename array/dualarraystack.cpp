@@ -1,146 +1,519 @@
 #include <iostream>
 #include <algorithm>
+#include <utility>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <string>
 
+// Move n elements from src into raw storage at dst and end the source
+// objects' lifetimes; a single memcpy when T is trivially copyable
 template<typename T>
+void relocate(T* src, int n, T* dst) {
+  if constexpr (std::is_trivially_copyable<T>::value) {
+    if (n > 0) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+  } else {
+    for (int i = 0; i < n; ++i) {
+      ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+      src[i].~T();
+    }
+  }
+}
+
+// Growth policies for ArrayStack: grow(cap) is the capacity a full stack
+// moves to, shrink(n, cap) the capacity to keep after a remove
+struct Doubling {
+  static int grow(int cap) { return std::max(2 * cap, 1); }
+  static int shrink(int, int cap) { return cap; }
+};
+
+// less slack per element, at the cost of more frequent reallocation
+struct OneAndHalf {
+  static int grow(int cap) { return std::max(cap + cap / 2, cap + 1); }
+  static int shrink(int, int cap) { return cap; }
+};
+
+// doubles, and halves once only a quarter is in use, so alternating
+// push/pop around a boundary never reallocates twice in a row
+struct Hysteresis {
+  static int grow(int cap) { return std::max(2 * cap, 1); }
+  static int shrink(int n, int cap) { return 4 * n <= cap ? cap / 2 : cap; }
+};
+
+template<typename T, typename Alloc>
+class DualArrayDeque;
+
+// N slots are stored inline, so a stack that never holds more than N
+// elements never touches the heap; larger buffers come from Alloc
+template<typename T, int N = 0, typename Growth = Doubling,
+         typename Alloc = std::allocator<T>>
 class ArrayStack {
 private:
-  T* a;
+  template<typename, typename> friend class DualArrayDeque;
+  using Traits = std::allocator_traits<Alloc>;
+
+  Alloc alloc;
+  T* a;          // raw storage, only [0, n) is constructed
   int n;
-  int capacity;
+  int cap;       // N while a points at buf
+  alignas(T) unsigned char buf[N > 0 ? N * sizeof(T) : 1];
+
+  T* allocate(int cap) {
+    return Traits::allocate(alloc, cap);
+  }
+
+  template<typename... Args>
+  void construct(T* p, Args&&... args) {
+    Traits::construct(alloc, p, std::forward<Args>(args)...);
+  }
+
+  T* local() {
+    return reinterpret_cast<T*>(buf);
+  }
+
+  void release() {
+    std::destroy(a, a + n);
+    if (cap > N) Traits::deallocate(alloc, a, cap);
+  }
+
+  // move the elements to storage for new_capacity slots, inline if it fits
+  void reallocate(int new_capacity) {
+    if (new_capacity <= N && cap == N) return;
+    T* b = new_capacity > N ? allocate(new_capacity) : local();
+    relocate(a, n, b);
+    if (cap > N) Traits::deallocate(alloc, a, cap);
+    a = b;
+    cap = std::max(new_capacity, N);
+  }
 
   void resize() {
-    int new_capacity = std::max(2* capacity, 1);
-    T* b = new T[new_capacity];
-    for(int i = 0; i < n ; ++i)
-      b[i] = a[i];
-    delete [] a;
-    a= b;
-    capacity = new_capacity;
+    reallocate(std::max(Growth::grow(cap), n + 1));
+  }
 
+  // take other's elements, stealing its buffer unless they are inline
+  // or it belongs to a different allocator
+  void take(ArrayStack& other) {
+    if (!Traits::is_always_equal::value && !(alloc == other.alloc)) {
+      a = local();
+      cap = N;
+      n = 0;
+      if (other.n > N) reallocate(other.n);
+      for (; n < other.n; ++n) construct(a + n, std::move(other.a[n]));
+      std::destroy(other.a, other.a + other.n);
+      other.n = 0;
+      return;
+    }
+    if (other.cap > N) {
+      a = other.a;
+      cap = other.cap;
+    } else {
+      a = local();
+      cap = N;
+      relocate(other.a, other.n, a);
+    }
+    n = other.n;
+    other.a = other.local();
+    other.n = 0;
+    other.cap = N;
   }
 
 public:
-    ArrayStack(int cap = 1) {
-        capacity = std::max(cap, 1); // initialize before use!
-        a = new T[capacity];         // now safe
+    ArrayStack(int capacity = 0, const Alloc& alloc = Alloc()) : alloc(alloc) {
         n = 0;
+        cap = N;
+        a = local();
+        if (capacity > N) reallocate(capacity);
     }
       // Copy constructor
-    ArrayStack(const ArrayStack& other) {
-        capacity = other.capacity;
-        n = other.n;
-        a = new T[capacity];
-        for (int i = 0; i < n; ++i)
-            a[i] = other.a[i];
+    ArrayStack(const ArrayStack& other)
+      : ArrayStack(other, Traits::select_on_container_copy_construction(other.alloc)) {}
+
+    // Copy into storage from a given allocator
+    ArrayStack(const ArrayStack& other, const Alloc& alloc) : ArrayStack(other.cap, alloc) {
+        for (; n < other.n; ++n) construct(a + n, other.a[n]);
     }
 
-    // Copy assignment operator
+    // Copy assignment operator, keeps this stack's allocator
     ArrayStack& operator=(const ArrayStack& other) {
         if (this != &other) {
-            delete[] a;  // clean up old memory
-            capacity = other.capacity;
-            n = other.n;
-            a = new T[capacity];
-            for (int i = 0; i < n; ++i)
-                a[i] = other.a[i];
+            ArrayStack copy(other, alloc);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // Move constructor
+    ArrayStack(ArrayStack&& other) noexcept : alloc(other.alloc) {
+        take(other);
+    }
+
+    // Move assignment operator
+    ArrayStack& operator=(ArrayStack&& other) noexcept(Traits::is_always_equal::value) {
+        if (this != &other) {
+            release();
+            take(other);
         }
         return *this;
     }
   ~ArrayStack() {
-    delete [] a;
+    release();
   }
 
   int size() const {
     return n;
   }
 
+  int capacity() const {
+    return cap;
+  }
+
+  Alloc get_allocator() const {
+    return alloc;
+  }
+
+  // true while the elements live in the inline buffer
+  bool isInline() const {
+    return cap == N;
+  }
+
   T get(int i) const {
     return a[i];
   }
 
+  T& operator[](int i) {
+    return a[i];
+  }
+
   T set(int i, T x) {
-    T old = a[i];
-    a[i] = x;
+    T old = std::move(a[i]);
+    a[i] = std::move(x);
     return old;
   }
 
-  void add(int i , T x) {
-    if (n == capacity) resize();
-    for ( int j = n; j > i; --j)
-      a[j] = a[j -1];
-    a[i] = x;
+  // construct an element in place at position i
+  template<typename... Args>
+  T& emplace(int i, Args&&... args) {
+    if (i == n && n < cap) {
+      construct(a + n, std::forward<Args>(args)...);
+      return a[n++];
+    }
+    T x(std::forward<Args>(args)...);   // args may refer into the stack
+    if (n == cap) resize();
+    if (i == n) {
+      construct(a + n, std::move(x));
+    } else if constexpr (std::is_trivially_copyable<T>::value) {
+      std::memmove(static_cast<void*>(a + i + 1), a + i, (n - i) * sizeof(T));
+      construct(a + i, std::move(x));
+    } else {
+      // the slot past the end is raw: move-construct into it, then shift
+      construct(a + n, std::move(a[n - 1]));
+      std::move_backward(a + i, a + n - 1, a + n);
+      a[i] = std::move(x);
+    }
     ++n;
+    return a[i];
+  }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args) {
+    return emplace(n, std::forward<Args>(args)...);
+  }
+
+  void add(int i , T x) {
+    emplace(i, std::move(x));
   }
 
   T remove(int i) {
-    T x = a[i];
-    for (int j = i; j < n-1; ++j)
-      a[j] = a[j + 1];
+    T x = std::move(a[i]);
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      std::memmove(static_cast<void*>(a + i), a + i + 1, (n - i - 1) * sizeof(T));
+    } else {
+      std::move(a + i + 1, a + n, a + i);
+    }
     --n;
+    a[n].~T();
+    int keep = Growth::shrink(n, cap);
+    if (keep < cap) reallocate(std::max(keep, n));
     return x;
   }
+
+  // append without shifting
+  void push_back(T x) {
+    emplace(n, std::move(x));
+  }
 	
 };
 
 
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>>
 class DualArrayDeque {
 private:
-  ArrayStack<T> front, back;
+  using Stack = ArrayStack<T, 0, Doubling, Alloc>;
+  using Traits = std::allocator_traits<Alloc>;
+
+  Stack front, back;
+
+  // incremental mode: balance() does not rebuild both stacks in one call.
+  // It allocates new_front/new_back and then every add or remove relocates
+  // rebuildRate more elements into them, working outwards from the middle
+  // while operations only touch the two tops. `moved` elements go from the
+  // bottom of the giving stack (back if fromBack) to the bottom of the other.
+  static const int rebuildRate = 8;
+  static const int minRebuild = 32;   // smaller deques are rebuilt at once
+  bool incremental = false;
+  bool rebuilding = false;
+  bool fromBack = false;
+  int moved = 0;
+  Stack new_front, new_back;
+
+  Stack& giver()    { return fromBack ? back : front; }
+  Stack& taker()    { return fromBack ? front : back; }
+  Stack& newGiver() { return fromBack ? new_back : new_front; }
+  Stack& newTaker() { return fromBack ? new_front : new_back; }
+
+  // position p (0 = bottom) of the old stack s, wherever it lives now
+  T& slot(Stack& s, int p) {
+    if (rebuilding) {
+      if (&s == &giver()) {
+        if (p < moved) {
+          if (moved - 1 - p < newTaker().n) return newTaker().a[moved - 1 - p];
+        } else if (p - moved < newGiver().n) {
+          return newGiver().a[p - moved];
+        }
+      } else if (moved + p < newTaker().n) {
+        return newTaker().a[moved + p];
+      }
+    }
+    return s.a[p];
+  }
+  const T& slot(const Stack& s, int p) const {
+    return const_cast<DualArrayDeque*>(this)->slot(const_cast<Stack&>(s), p);
+  }
+
+  // element i by reference
+  T& at(int i) {
+    if (i < front.size())
+      return slot(front, front.size() - i - 1);
+    return slot(back, i - front.size());
+  }
+
+  // Rebuild both stacks around the middle in O(n): front is filled in
+  // reverse with appends, elements are moved rather than copied, and the
+  // new stacks are moved into place.
+  void rebuild() {
+    int n = this->size();
+    int nf = n/2;
+    int nb = n - nf;
+
+    Stack
+      new_front(std::max(2*nf, 1), front.alloc);
+    for (int i = nf - 1; i >= 0; --i)
+      new_front.push_back(std::move(at(i)));
+
+    Stack
+      new_back(std::max(2*nb, 1), front.alloc);
+    for ( int i = 0; i < nb; ++i)
+      new_back.push_back(std::move(at(nf + i)));
+
+    front = std::move(new_front);
+    back = std::move(new_back);
+  }
+
+  // one side is three times the other, or in incremental mode a stack
+  // is three quarters full (it must not double mid-operation) or both
+  // are mostly empty
+  bool needsRebuild() const {
+    int f = front.size(), b = back.size();
+    if (3* f < b || 3* b < f) return true;
+    if (!incremental) return false;
+    int room = front.capacity() + back.capacity();
+    return 4*f >= 3*front.capacity() || 4*b >= 3*back.capacity()
+        || (room > 2*minRebuild && 8*size() < room);
+  }
 
   void balance() {
-    if (3* front.size() < back.size() || 3* back.size() < front.size()) {
-      int n = this->size();
-      int nf = n/2;
-      int nb = n - nf;
-      
-      ArrayStack<T>
-        new_front(std::max(2*nf, 1));
-      for (int i = 0; i < nf; ++i)
-        new_front.add(0, this->get(i));
-      
-      ArrayStack<T>
-        new_back(std::max(2*nb, 1));
-      for ( int i = 0; i < nb; ++i)
-        new_back.add(i, this->get(nf + i));
-
-      front = new_front;
-      back = new_back;
+    if (rebuilding) {
+      rebuildStep(rebuildRate);
+    } else if (needsRebuild()) {
+      if (!incremental || size() < minRebuild) rebuild();
+      else startRebuild();
+    }
+  }
+
+  void startRebuild() {
+    int n = size();
+    int nf = n/2;
+    fromBack = front.size() < nf;
+    moved = fromBack ? nf - front.size() : front.size() - nf;
+    new_front = Stack(n, front.alloc);
+    new_back = Stack(n, front.alloc);
+    rebuilding = true;
+    rebuildStep(rebuildRate);
+  }
+
+  // relocate up to k elements: first the taker's new stack (moved
+  // elements of the giver, then the taker itself), then the giver's rest
+  void rebuildStep(int k) {
+    Stack& give = giver();
+    Stack& take = taker();
+    Stack& ngive = newGiver();
+    Stack& ntake = newTaker();
+    for (; k > 0; --k) {
+      if (ntake.n < moved + take.n) {
+        int q = ntake.n;
+        if (q == ntake.cap) ntake.resize();
+        relocate(q < moved ? &give.a[moved - 1 - q] : &take.a[q - moved], 1, ntake.a + q);
+        ++ntake.n;
+      } else if (ngive.n < give.n - moved) {
+        int q = ngive.n;
+        if (q == ngive.cap) ngive.resize();
+        relocate(&give.a[moved + q], 1, ngive.a + q);
+        ++ngive.n;
+      } else {
+        break;
+      }
+    }
+    if (ntake.n == moved + take.n && ngive.n == give.n - moved) {
+      // every live element has moved out, the old slots are all raw
+      front.n = 0;
+      back.n = 0;
+      front = std::move(new_front);   // frees the old buffers
+      back = std::move(new_back);
+      rebuilding = false;
     }
   }
 
+  // complete a pending rebuild, for operations away from the two tops
+  void finishRebuild() {
+    if (rebuilding) rebuildStep(front.n + back.n + 1);
+  }
+
+  // remove the top of s; during a rebuild it may already live in a new stack
+  T popTop(Stack& s) {
+    int p = s.n - 1;
+    T& e = slot(s, p);
+    if (&e == &s.a[p])
+      return s.remove(p);
+    Stack& ns = &s == &giver() ? newGiver() : newTaker();
+    T x = std::move(e);
+    e.~T();
+    --ns.n;
+    --s.n;        // the old slot was already relocated
+    return x;
+  }
+
 public:
-  DualArrayDeque() : front(), back() {}
+  DualArrayDeque(const Alloc& alloc = Alloc())
+    : front(0, alloc), back(0, alloc), new_front(0, alloc), new_back(0, alloc) {}
+
+  DualArrayDeque(const DualArrayDeque& other)
+    : DualArrayDeque(other, Traits::select_on_container_copy_construction(other.front.alloc)) {}
+
+  // copy into storage from a given allocator
+  DualArrayDeque(const DualArrayDeque& other, const Alloc& alloc) : DualArrayDeque(alloc) {
+    incremental = other.incremental;
+    back = Stack(other.size(), alloc);
+    for (int i = 0; i < other.size(); ++i)
+      back.push_back(other.get(i));
+    rebuild();
+  }
+
+  DualArrayDeque(DualArrayDeque&& other) : DualArrayDeque(other.front.alloc) {
+    swap(other);
+  }
+
+  DualArrayDeque& operator=(DualArrayDeque other) {
+    swap(other);
+    return *this;
+  }
+
+  // old stacks hold relocated slots until a rebuild completes
+  ~DualArrayDeque() {
+    finishRebuild();
+  }
+
+  // with different allocators the stacks swap elements, not buffers,
+  // which a half-relocated rebuild cannot survive
+  void swap(DualArrayDeque& other) {
+    if (!Traits::is_always_equal::value && !(front.alloc == other.front.alloc)) {
+      finishRebuild();
+      other.finishRebuild();
+    }
+    std::swap(front, other.front);
+    std::swap(back, other.back);
+    std::swap(new_front, other.new_front);
+    std::swap(new_back, other.new_back);
+    std::swap(incremental, other.incremental);
+    std::swap(rebuilding, other.rebuilding);
+    std::swap(fromBack, other.fromBack);
+    std::swap(moved, other.moved);
+  }
+
+  // incremental rebalancing keeps add/remove at both ends O(1) worst case
+  void setIncremental(bool on) {
+    if (!on) finishRebuild();
+    incremental = on;
+  }
+  bool isIncremental() const { return incremental; }
+
+  Alloc get_allocator() const { return front.alloc; }
 
   int size() const {
     return front.size() + back.size();
   }
  T get(int i) const {
     if ( i < front.size()) {
-      return front.get(front.size() - i -1);
+      return slot(front, front.size() - i -1);
     } else {
-      return back.get(i - front.size());
+      return slot(back, i - front.size());
     }
   } 
 
   T set(int i , T x) {
-    if (i < front.size()) {
-      return front.set(front.size() - i - 1, x);
-    } else {
-    return back.set(i - front.size(), x);
-    }
+    T& e = at(i);
+    T old = std::move(e);
+    e = std::move(x);
+    return old;
   }
 
   void add(int i ,T x) {
+    emplace(i, std::move(x));
+  }
+
+  // construct an element in place at index i
+  template<typename... Args>
+  void emplace(int i, Args&&... args) {
+    if (rebuilding) {
+      // only pushes onto a top with room left can run alongside a rebuild
+      bool top = i == size() ? back.n < back.cap
+               : i == 0 && front.n > 0 && front.n < front.cap;
+      if (!top) finishRebuild();
+    }
     if (i < front.size()) {
-      front.add(front.size() - i, x);
+      front.emplace(front.size() - i, std::forward<Args>(args)...);
     } else {
-      back.add(i - front.size(), x);
+      back.emplace(i - front.size(), std::forward<Args>(args)...);
     }
     balance();
   }
    
   T remove(int i ) {
+    if (rebuilding) {
+      // popping a top is safe unless it reaches the giver's moved part
+      Stack* s = i == 0 && front.n > 0 ? &front
+                       : i == size() - 1 && back.n > 0 ? &back : nullptr;
+      if (s == nullptr || (s == &giver() && s->n <= moved)) finishRebuild();
+      else {
+        T x = popTop(*s);
+        balance();
+        return x;
+      }
+    }
     T x;
     if (i < front.size()) {
       x = front.remove(front.size() -i -1);
@@ -153,6 +526,122 @@ public:
 
 };
 
+// Many short-lived small stacks: heap-backed versus 16 inline slots
+template<int N>
+double smallStacks(int stacks, int each) {
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < stacks; ++s) {
+        ArrayStack<int, N> st;
+        for (int i = 0; i < each; ++i) st.push_back(i);
+        while (st.size() > 0) sum += st.remove(st.size() - 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (sum < 0) std::cout << sum;   // keep the loop
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Reallocations and leftover capacity for one policy: grow to `peak`,
+// drain to `low`, then push/pop across that size
+template<typename Growth>
+void growthPolicy(const char* name, int peak, int low) {
+    ArrayStack<int, 0, Growth> st;
+    int reallocs = 0;
+    int cap = st.capacity();
+    auto note = [&] {
+        if (st.capacity() != cap) ++reallocs;
+        cap = st.capacity();
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < peak; ++i) { st.push_back(i); note(); }
+    int peakCap = st.capacity();
+    while (st.size() > low) { st.remove(st.size() - 1); note(); }
+    int drainedCap = st.capacity();
+    for (int i = 0; i < 1000; ++i) {
+        st.push_back(i); note();
+        st.remove(st.size() - 1); note();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "  " << name << ": " << reallocs << " reallocations, capacity "
+              << peakCap << " at " << peak << ", " << drainedCap << " at " << low
+              << ", " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+}
+
+// Forwards to another resource and counts the calls, so a benchmark can
+// tell which operations reached the allocator
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+    long long calls = 0;
+
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++calls;
+        return upstream->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        ++calls;
+        upstream->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void printLatencies(const char* label, std::vector<long long>& samples) {
+    std::cout << label << samples.size() << " ops";
+    if (samples.empty()) {
+        std::cout << '\n';
+        return;
+    }
+    std::vector<long long> buckets(40, 0);
+    for (long long ns : samples) {
+        int b = 0;
+        while ((2LL << b) <= ns) ++b;
+        ++buckets[b];
+    }
+    std::sort(samples.begin(), samples.end());
+    std::size_t n = samples.size();
+    std::cout << "  p50=" << samples[n / 2]
+              << "ns  p99=" << samples[n * 99 / 100]
+              << "ns  p99.9=" << samples[n * 999 / 1000]
+              << "ns  max=" << samples.back() << "ns\n";
+    for (int b = 0; b < 40; ++b) {
+        if (buckets[b] == 0) continue;
+        std::cout << "    <" << (2LL << b) << "ns: " << buckets[b] << '\n';
+    }
+}
+
+// Per-operation latency of a deque used as a growing queue (two adds at
+// the back per remove at the front), bucketed by powers of two in ns.
+// Operations that called the allocator (stack growth, the buffers a
+// rebuild allocates and frees) are reported apart from the rest.  The
+// deque's memory comes from an arena touched up front, so first-touch
+// page faults in freshly mapped buffers do not land in either group.
+void rebalanceHistogram(bool incremental, int ops) {
+    std::vector<std::byte> arena(std::size_t(ops) * 32);   // ~2x what the run allocates
+    std::pmr::monotonic_buffer_resource prefaulted(arena.data(), arena.size());
+    CountingResource counted(&prefaulted);
+    DualArrayDeque<int, std::pmr::polymorphic_allocator<int>> q(&counted);
+    q.setIncremental(incremental);
+    std::vector<long long> steady, allocating;
+    steady.reserve(ops);
+    for (int i = 0; i < ops; ++i) {
+        long long calls = counted.calls;
+        auto t0 = std::chrono::steady_clock::now();
+        if (i % 3 == 2) q.remove(0);
+        else            q.add(q.size(), i);
+        auto t1 = std::chrono::steady_clock::now();
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        (counted.calls == calls ? steady : allocating).push_back(ns);
+    }
+    std::cout << (incremental ? "incremental" : "rebuild") << '\n';
+    printLatencies("  steady:     ", steady);
+    printLatencies("  allocating: ", allocating);
+}
+
 int main() {
     DualArrayDeque<int> dq;
 
@@ -179,6 +668,67 @@ int main() {
         std::cout << dq.get(i) << ' ';
     std::cout << "\n";
 
+    // Rebalancing is linear, so building a large deque from one end stays
+    // fast; incremental mode spreads the same work over the operations
+    for (bool incremental : {false, true}) {
+        DualArrayDeque<int> big;
+        big.setIncremental(incremental);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 500000; ++i)
+            big.add(big.size(), i);
+        for (int i = 0; i < 400000; ++i)
+            big.remove(0);
+        auto end = std::chrono::steady_clock::now();
+        bool ordered = true;
+        for (int i = 0; i < big.size(); ++i)
+            ordered = ordered && big.get(i) == 400000 + i;
+        std::cout << "500k appends + 400k front removals"
+                  << (incremental ? " (incremental): " : ": ")
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms"
+                  << (ordered ? "" : " (order broken!)") << "\n";
+    }
+
+    ArrayStack<std::string, 4> small;
+    for (const char* w : {"one", "two", "three"}) small.push_back(w);
+    std::cout << "\n3 strings in ArrayStack<std::string, 4>: "
+              << (small.isInline() ? "inline" : "on the heap");
+    small.push_back("four");
+    small.push_back("five");
+    std::cout << ", after 5: " << (small.isInline() ? "inline" : "on the heap")
+              << " (capacity " << small.capacity() << ")\n";
+
+    std::cout << "1M stacks of 10 ints: heap " << smallStacks<0>(1000000, 10)
+              << " ms, inline " << smallStacks<16>(1000000, 10) << " ms\n";
+
+    std::cout << "Growth policies (1M pushes, drain to 1000, 1000 push/pop pairs):\n";
+    growthPolicy<Doubling>("Doubling  ", 1000000, 1000);
+    growthPolicy<OneAndHalf>("OneAndHalf", 1000000, 1000);
+    growthPolicy<Hysteresis>("Hysteresis", 1000000, 1000);
+
+    // a request-scoped batch: deques and their strings come from a pool
+    // over a monotonic arena, and the arena frees everything at scope exit
+    {
+        std::pmr::monotonic_buffer_resource arena(1 << 16);
+        std::pmr::unsynchronized_pool_resource pool(&arena);
+        using Alloc = std::pmr::polymorphic_allocator<std::pmr::string>;
+        DualArrayDeque<std::pmr::string, Alloc> names(&pool);
+        names.setIncremental(true);
+        for (int i = 0; i < 1000; ++i)
+            names.emplace(names.size(), "request-scoped name number " + std::to_string(i));
+        for (int i = 0; i < 900; ++i)
+            names.remove(0);
+        ArrayStack<std::pmr::string, 4, Doubling, Alloc> ids(0, &pool);
+        ids.emplace_back("kept inline, characters in the pool");
+        std::cout << "pmr deque: " << names.size() << " names, front \"" << names.get(0)
+                  << "\", strings from the pool: " << std::boolalpha
+                  << (names.get_allocator().resource() == &pool
+                      && ids[0].get_allocator().resource() == &pool) << "\n";
+    }
+
+    std::cout << "\nLatency histogram: rebuild vs incremental rebalancing\n";
+    rebalanceHistogram(false, 3000000);
+    rebalanceHistogram(true, 3000000);
+
     return 0;
 }
 
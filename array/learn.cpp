@@ -3,71 +3,260 @@
 #include <cassert>
 #include <ostream>
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 
 
 
 
+// Move n elements from src into raw storage at dst and end the source
+// objects' lifetimes; a single memcpy when T is trivially copyable
 template <typename T>
+void relocate(T* src, int n, T* dst) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (n > 0) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+    } else {
+        for (int i = 0; i < n; ++i) {
+            ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+// Allocator for very large buffers.  Requests of at least mapThreshold
+// bytes get their own anonymous mapping, started 2 MB aligned and advised
+// MADV_HUGEPAGE so the kernel can back it with transparent huge pages and
+// random access takes far fewer TLB misses.  Where THP is disabled the
+// advice just fails and the mapping keeps 4 KB pages.  Smaller requests go
+// to operator new.  reallocate() grows a mapping with mremap, which moves
+// page-table entries instead of copying bytes; a moved mapping is only
+// guaranteed page alignment.
+template <typename T>
+struct MmapAllocator {
+    using value_type = T;
+    static constexpr std::size_t hugePage = std::size_t(2) << 20;
+    static constexpr std::size_t mapThreshold = hugePage;
+
+    MmapAllocator() = default;
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>&) {}
+
+    static std::size_t pageSize() {
+        static const std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+        return page;
+    }
+    // mremap(MREMAP_MAYMOVE) only keeps page alignment, so a T aligned
+    // beyond a page never takes the mapped path
+    static bool mapped(std::size_t n) {
+        return n * sizeof(T) >= mapThreshold && alignof(T) <= pageSize();
+    }
+    static std::size_t mapLength(std::size_t n) {
+        return (n * sizeof(T) + hugePage - 1) & ~(hugePage - 1);
+    }
+    static void adviseHuge(void* p, std::size_t len) {
+        madvise(p, len, MADV_HUGEPAGE);   // EINVAL without THP: stay on small pages
+    }
+
+    // Small buffers; over-aligned T needs the aligned operator new/delete
+    static constexpr bool overAligned = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static T* heapAllocate(std::size_t n) {
+        if constexpr (overAligned) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        } else {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+    }
+    static void heapDeallocate(T* p) {
+        if constexpr (overAligned) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    // Mappings are page aligned at least; mapped() already sent any T
+    // aligned beyond a page to the heap
+    T* allocate(std::size_t n) {
+        if (!mapped(n)) {
+            return heapAllocate(n);
+        }
+        // map one huge page extra and trim, so the buffer starts 2 MB aligned
+        std::size_t len = mapLength(n);
+        void* raw = mmap(nullptr, len + hugePage, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+        std::uintptr_t aligned = (start + hugePage - 1) & ~(hugePage - 1);
+        if (aligned > start) munmap(raw, aligned - start);
+        munmap(reinterpret_cast<void*>(aligned + len), start + hugePage - aligned);
+        adviseHuge(reinterpret_cast<void*>(aligned), len);
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if (!mapped(n)) heapDeallocate(p);
+        else munmap(p, mapLength(n));
+    }
+
+    // Resize a buffer keeping its first min(oldN, newN) slots as raw bytes
+    T* reallocate(T* p, std::size_t oldN, std::size_t newN) {
+        if (mapped(oldN) && mapped(newN)) {
+            void* q = mremap(p, mapLength(oldN), mapLength(newN), MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) throw std::bad_alloc();
+            adviseHuge(q, mapLength(newN));
+            return static_cast<T*>(q);
+        }
+        T* q = allocate(newN);
+        std::memcpy(static_cast<void*>(q), p, std::min(oldN, newN) * sizeof(T));
+        deallocate(p, oldN);
+        return q;
+    }
+
+    friend bool operator==(const MmapAllocator&, const MmapAllocator&) { return true; }
+};
+
+// Storage and element construction go through Alloc, so a
+// std::pmr::polymorphic_allocator puts the whole array (and, for pmr
+// element types, the elements' own memory) in one memory resource.
+template <typename T, typename Alloc = std::allocator<T>>
 class Array {
 private:
-    T* a;
+    using Traits = std::allocator_traits<Alloc>;
+
+    Alloc alloc;
+    T* a;       // raw storage, only [0, n) holds constructed elements
     int length; // Total capacity of the array
     int n; // current number of elements in use
-      
+
+    // The allocator can resize a buffer itself (MmapAllocator, via mremap);
+    // only safe when elements may be moved as raw bytes
+    static constexpr bool reallocates = std::is_trivially_copyable<T>::value
+        && requires(Alloc& al, T* p, std::size_t k) { al.reallocate(p, k, k); };
+
+    T* allocate(int len) {
+        return Traits::allocate(alloc, std::max(len, 1));
+    }
+    void deallocate(T* p, int len) {
+        if (p != nullptr) Traits::deallocate(alloc, p, std::max(len, 1));
+    }
+
+    template <typename... Args>
+    void construct(T* p, Args&&... args) {
+        Traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    // copy or move other's elements into b, constructed with our allocator
+    template <typename Src>
+    void constructFrom(Src& other, T* b) {
+        for (int i = 0; i < other.n; ++i) {
+            if constexpr (std::is_const<Src>::value) construct(b + i, other.a[i]);
+            else construct(b + i, std::move(other.a[i]));
+        }
+    }
+
     void resize() {
-        Array<T> b(std::max(1, 2 * n));
-        std::copy(a, a + n, b.a);
-		b.n = n;
-        *this = std::move(b);
+        int new_length = std::max(1, 2 * n);
+        T* b;
+        if constexpr (reallocates) {
+            b = a != nullptr ? alloc.reallocate(a, std::max(length, 1), new_length)
+                             : allocate(new_length);
+        } else {
+            b = allocate(new_length);
+            relocate(a, n, b);
+            deallocate(a, length);
+        }
+        std::cout << "Resized array from " << length << " to " << new_length << std::endl;
+        a = b;
+        length = new_length;
     }
 
 public:
-    Array(int len) : length(len), n(0) {
-        a = new T[length];
+    Array(int len, const Alloc& alloc = Alloc())
+      : alloc(alloc), a(allocate(len)), length(len), n(0) {
         std::cout << "Created array of size " << length << std::endl;
     }
     
     ~Array() {
         if (a != nullptr) {
-            delete[] a;
+            std::destroy(a, a + n);
+            deallocate(a, length);
             std::cout << "Destroyed array" << std::endl;
         }
     }
     
     // Copy constructor
-    Array(const Array<T>& other) : length(other.length), n(other.n) {
-        a = new T[length];
-        std::copy(other.a, other.a + n, a);
+    Array(const Array& other)
+      : Array(other, Traits::select_on_container_copy_construction(other.alloc)) {}
+
+    // Copy into storage from a given allocator
+    Array(const Array& other, const Alloc& alloc)
+      : alloc(alloc), a(allocate(other.length)), length(other.length), n(other.n) {
+        constructFrom(other, a);
         std::cout << "Copied array" << std::endl;
     }
     
     // Copy assignment operator
-    Array<T>& operator=(const Array<T>& other) {
+    // Assignment keeps this array's allocator
+    Array& operator=(const Array& other) {
         if (this == &other) {
             return *this;
         }
         
-        delete[] a;
+        T* b = allocate(other.length);
+        constructFrom(other, b);
+        if (a != nullptr) {
+            std::destroy(a, a + n);
+            deallocate(a, length);
+        }
+        a = b;
         length = other.length;
         n = other.n;
-        a = new T[length];
-        std::copy(other.a, other.a + n, a);
         std::cout << "Copy assigned array" << std::endl;
         return *this;
     }
     
     // Move assignment operator (fixed signature)
-    Array<T>& operator=(Array<T>&& other) noexcept {
+    Array& operator=(Array&& other) noexcept(Traits::is_always_equal::value) {
         if (this == &other) {
             return *this;
         }
         
         if (a != nullptr) {
-            delete[] a;
+            std::destroy(a, a + n);
+            deallocate(a, length);
         }
         
+        if (!Traits::is_always_equal::value && !(alloc == other.alloc)) {
+            // other's buffer belongs to another allocator: move the elements
+            a = allocate(other.length);
+            constructFrom(other, a);
+            length = other.length;
+            n = other.n;
+            std::destroy(other.a, other.a + other.n);
+            other.n = 0;
+            std::cout << "Moved array elements" << std::endl;
+            return *this;
+        }
         a = other.a;
         other.a = nullptr;
         length = other.length;
@@ -96,6 +285,10 @@ public:
     int capacity() const {
         return length;
     }
+
+    Alloc get_allocator() const {
+        return alloc;
+    }
     
     T get(int i) const {
         assert(i >= 0 && i < n);
@@ -104,36 +297,275 @@ public:
     
     T set(int i, T x) {
         assert(i >= 0 && i < n);
-        T y = a[i];
-        a[i] = x;
+        T y = std::move(a[i]);
+        a[i] = std::move(x);
         return y;
     }
     
     T remove(int i) {
         assert(i >= 0 && i < n);
-        T x = a[i];
-        std::copy(a + i + 1, a + n, a + i);
+        T x = std::move(a[i]);
+        std::move(a + i + 1, a + n, a + i);
         n--;
+        a[n].~T();
         return x;
     }
     
-    void add(int i, T x) {
+    // Construct an element in place at index i
+    template <typename... Args>
+    T& emplace(int i, Args&&... args) {
         assert(i >= 0 && i <= n); // Can insert at position n (end)
+        if (i == n && n < length) {
+            construct(a + n, std::forward<Args>(args)...);
+            return a[n++];
+        }
+        T x(std::forward<Args>(args)...);  // args may refer into the array
         if (n + 1 > length) {
             resize();
         }
-        std::copy_backward(a + i, a + n, a + n + 1);
-        a[i] = x;
+        if (i == n) {
+            construct(a + n, std::move(x));
+        } else {
+            // the slot past the end is raw: move-construct into it, then shift
+            construct(a + n, std::move(a[n - 1]));
+            std::move_backward(a + i, a + n - 1, a + n);
+            a[i] = std::move(x);
+        }
         n++;
+        return a[i];
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return emplace(n, std::forward<Args>(args)...);
+    }
+
+    void add(int i, T x) {
+        emplace(i, std::move(x));
     }
     
     void push_back(T x) {
-        add(n, x);
+        emplace(n, std::move(x));
     }
 };
 
+// Array kept in a memory-mapped file so it survives restarts.  The file is
+// a small header followed by the elements.  Opening maps the file and
+// reads only the header, so startup is O(1) and element pages fault in
+// lazily as they are used.  Elements live in the file as raw bytes, hence
+// trivially copyable T only.  Writes reach the page cache immediately and
+// the disk at the kernel's pace; sync() makes them durable.
+template <typename T>
+class MappedArray {
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "MappedArray stores raw bytes");
+
+    struct Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t elemSize;
+        std::uint64_t size;
+        std::uint64_t capacity;
+    };
+    static constexpr std::uint64_t fileMagic = 0x594152524150414dULL;   // "MAPARRAY" on disk
+    static constexpr std::uint32_t fileVersion = 1;
+    static constexpr std::size_t dataOffset = 64;   // elements start cache-line aligned
+    static constexpr std::uint64_t maxCapacity = std::numeric_limits<int>::max();   // indices are int
+    static_assert(sizeof(Header) <= dataOffset && alignof(T) <= dataOffset);
+
+    int fd = -1;
+    char* base = nullptr;   // the whole file
+    std::size_t mapped = 0;
+    Header* h = nullptr;
+    T* a = nullptr;
+
+    static std::size_t fileBytes(std::uint64_t cap) {
+        return dataOffset + cap * sizeof(T);
+    }
+
+    [[noreturn]] static void fail(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void attach(void* p, std::size_t len) {
+        base = static_cast<char*>(p);
+        mapped = len;
+        h = reinterpret_cast<Header*>(base);
+        a = reinterpret_cast<T*>(base + dataOffset);
+    }
+
+    void close() {
+        if (base != nullptr) munmap(base, mapped);
+        if (fd >= 0) ::close(fd);
+        base = nullptr;
+        fd = -1;
+    }
+
+    // Extend the file and the mapping to cap elements, doubling up to
+    // maxCapacity.  The header's capacity is only raised once both succeeded.
+    void resize() {
+        std::uint64_t cap = std::min(maxCapacity, std::max<std::uint64_t>(1, 2 * h->size));
+        std::size_t len = fileBytes(cap);
+        if (ftruncate(fd, len) != 0) fail("ftruncate");
+        void* p = mremap(base, mapped, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) fail("mremap");
+        attach(p, len);
+        std::cout << "Resized mapped array from " << h->capacity << " to " << cap << std::endl;
+        h->capacity = cap;
+    }
+
+    void open(const char* path, int len) {
+        fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) fail("open");
+        struct stat st;
+        if (fstat(fd, &st) != 0) fail("fstat");
+        if (st.st_size == 0) {
+            std::uint64_t cap = std::max(len, 1);
+            if (ftruncate(fd, fileBytes(cap)) != 0) fail("ftruncate");
+            void* p = mmap(nullptr, fileBytes(cap), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) fail("mmap");
+            attach(p, fileBytes(cap));
+            *h = Header{fileMagic, fileVersion, sizeof(T), 0, cap};
+            std::cout << "Created mapped array of size " << cap << std::endl;
+            return;
+        }
+        if (std::size_t(st.st_size) < dataOffset) {
+            throw std::runtime_error("not a mapped array file");
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) fail("mmap");
+        attach(p, st.st_size);
+        if (h->magic != fileMagic) throw std::runtime_error("not a mapped array file");
+        if (h->version != fileVersion) throw std::runtime_error("unsupported mapped array version");
+        if (h->elemSize != sizeof(T)) throw std::runtime_error("mapped array element size mismatch");
+        // capacity comes from the file: bound it by what was mapped before
+        // multiplying, so a huge value cannot wrap fileBytes() around
+        if (h->capacity > (mapped - dataOffset) / sizeof(T)
+            || h->capacity > maxCapacity
+            || h->size > h->capacity) {
+            throw std::runtime_error("truncated mapped array file");
+        }
+        std::cout << "Opened mapped array with " << h->size << " elements" << std::endl;
+    }
+
+public:
+    // Open path, creating it with room for len elements if it is empty
+    MappedArray(const char* path, int len = 1) {
+        try {
+            open(path, len);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    ~MappedArray() {
+        close();
+    }
+
+    // one mapping per file
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
+
+    // Flush the elements and header to disk: msync writes the dirty
+    // pages, fdatasync the file length that resize() changed
+    void sync() {
+        if (msync(base, fileBytes(h->size), MS_SYNC) != 0) fail("msync");
+        if (fdatasync(fd) != 0) fail("fdatasync");
+    }
+
+    T& operator[](int i) {
+        assert(i >= 0 && i < size());
+        return a[i];
+    }
+
+    const T& operator[](int i) const {
+        assert(i >= 0 && i < size());
+        return a[i];
+    }
+
+    int size() const {
+        return int(h->size);
+    }
+
+    int capacity() const {
+        return int(h->capacity);
+    }
+
+    T get(int i) const {
+        assert(i >= 0 && i < size());
+        return a[i];
+    }
 
+    T set(int i, T x) {
+        assert(i >= 0 && i < size());
+        T y = a[i];
+        a[i] = x;
+        return y;
+    }
+
+    void add(int i, T x) {
+        int n = size();
+        assert(i >= 0 && i <= n);
+        if (h->size == maxCapacity) throw std::length_error("mapped array is full");
+        if (h->size + 1 > h->capacity) {
+            resize();
+        }
+        std::memmove(static_cast<void*>(a + i + 1), a + i, (n - i) * sizeof(T));
+        a[i] = x;
+        h->size++;   // after the element, so the header never covers a stale slot
+    }
 
+    T remove(int i) {
+        int n = size();
+        assert(i >= 0 && i < n);
+        T x = a[i];
+        std::memmove(static_cast<void*>(a + i), a + i + 1, (n - i - 1) * sizeof(T));
+        h->size--;
+        return x;
+    }
+
+    void push_back(T x) {
+        add(size(), x);
+    }
+};
+
+// Transparent huge pages backing this process, from smaps_rollup (-1 if unavailable)
+long long anonHugePagesKB() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    const std::string key = "AnonHugePages:";
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0) return std::stoll(line.substr(key.size()));
+    }
+    return -1;
+}
+
+// Grow an int array to n elements from n/16, then time random get/set.
+// The indices come from an LCG so the loop measures memory, not the RNG.
+template <typename Alloc>
+void randomAccess(const char* label, int n, int ops) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    Array<int, Alloc> arr(n / 16);
+    auto t0 = Clock::now();
+    for (int i = 0; i < n; ++i) arr.push_back(i);
+    auto t1 = Clock::now();
+    std::uint32_t x = 12345;
+    long long sum = 0;
+    for (int k = 0; k < ops; ++k) {
+        x = x * 1664525u + 1013904223u;
+        int i = int(x % std::uint32_t(n));
+        sum += arr.get(i);
+        arr.set(i, int(sum));
+    }
+    auto t2 = Clock::now();
+    std::cout << label << ": grow " << ms(t1 - t0) << " ms, " << ops
+              << " random get/set " << ms(t2 - t1) << " ms, AnonHugePages "
+              << anonHugePagesKB() << " kB (checksum " << (sum & 0xff) << ")\n";
+}
 
 int main() {
     std::cout << "--- Creating array ---\n";
@@ -181,6 +613,62 @@ int main() {
         std::cout << movedArr[i] << " ";
     std::cout << "\n";
 
+    std::cout << "--- Emplacing strings ---\n";
+    Array<std::string> words(1);
+    words.emplace_back(3, 'a');          // "aaa", built in place
+    words.emplace_back("grow");          // strings are moved, not copied, on resize
+    words.emplace(1, "middle");
+    for (int i = 0; i < words.size(); ++i)
+        std::cout << words[i] << " ";
+    std::cout << "\nRemoved: " << words.remove(0) << "\n";
+
+    std::cout << "--- Arrays in an arena ---\n";
+    {
+        // one request's worth of arrays: the pool recycles blocks freed by
+        // resizing, the arena under it is released in one go at scope exit
+        std::pmr::monotonic_buffer_resource arena(1 << 16);
+        std::pmr::unsynchronized_pool_resource pool(&arena);
+        using PmrArray = Array<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+        PmrArray names(1, &pool);
+        names.emplace_back("a string long enough to need its own buffer");
+        names.emplace_back("short");
+        PmrArray copy(names, &pool);
+        std::cout << "Element strings share the pool: " << std::boolalpha
+                  << (names[0].get_allocator().resource() == &pool
+                      && copy[1].get_allocator().resource() == &pool) << "\n";
+    }
+
+    std::cout << "--- Huge-page backed storage ---\n";
+    {
+        // 512 MB of ints: the default path copies on every doubling and
+        // walks 4 KB pages; MmapAllocator grows with mremap on 2 MB pages
+        const int big = 1 << 27;
+        randomAccess<std::allocator<int>>("std::allocator", big, 1 << 24);
+        randomAccess<MmapAllocator<int>>("MmapAllocator ", big, 1 << 24);
+    }
+
+    std::cout << "--- Persistent mapped array ---\n";
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "learn_mapped_array.bin").string();
+        std::filesystem::remove(path);
+        const int count = 1 << 22;
+        {
+            MappedArray<int> saved(path.c_str(), count);
+            for (int i = 0; i < count; ++i) saved.push_back(i);
+            saved.add(0, -1);          // shifts inside the mapping
+            saved.remove(0);
+            saved.sync();
+        }
+        // a restart: only the header is read, pages load as they are touched
+        auto t0 = std::chrono::steady_clock::now();
+        MappedArray<int> reopened(path.c_str());
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << "Reopened " << reopened.size() << " elements in "
+                  << std::chrono::duration<double, std::micro>(t1 - t0).count()
+                  << " us, last = " << reopened[reopened.size() - 1] << "\n";
+        std::filesystem::remove(path);
+    }
+
     std::cout << "--- All tests completed ---\n";
     return 0;
 }
@@ -3,51 +3,465 @@
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
+#include <chrono>
+#include <iterator>
+#include <type_traits>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <utility>
+#include <sys/mman.h>
 
-template <class T>
+// Blocks, the block index and the elements all come from Alloc
+template <class T, class Alloc = std::allocator<T>>
 class RootishArray {
 private:
-  std::vector<T*> blocks;
+  using Traits = std::allocator_traits<Alloc>;
+  template <class U>
+  using Rebind = typename Traits::template rebind_alloc<U>;
+
+  Alloc alloc;
+  std::vector<T*, Rebind<T*>> blocks;    // raw storage, only the first n elements are constructed
+  std::vector<int, Rebind<int>> offsets; // rotation of each block, see tiered mode
   int n;
 
-  int i2b(int i) const {
-    double db = (-3.0 + sqrt(9+8*i)) / 2.0;
-    return (int)ceil(db);
+  // shrink hysteresis and block recycling: up to slack empty blocks stay
+  // attached past the last element, and up to spareLimit released blocks
+  // are parked in spare instead of deleted.  Blocks are released and grown
+  // one at a time, so spare always holds consecutive sizes and its top is
+  // exactly the block the next grow() needs.
+  int slack = 1;
+  int spareLimit = 2;
+  std::vector<T*, Rebind<T*>> spare;
+  int minBlocks = 0;          // floor set by reserve()
+  long long allocations = 0;  // blocks obtained from the allocator
+
+  // tiered-vector mode: block b is a circular buffer starting at
+  // offsets[b], so an insert/remove shifts inside one block and then
+  // rotates each later block by one in O(1) -- O(sqrt n) overall
+  bool tiered = false;
+
+  // optional huge-page region (mapRegion): block b < regionBlocks lives at
+  // region + base(b), so the blocks sit back to back in one 2 MB aligned
+  // mapping instead of being sqrt(n)-sized heap chunks spread over 4 KB
+  // pages.  Region blocks bypass Alloc; later blocks still use it.
+  static constexpr std::size_t hugePage = std::size_t(2) << 20;
+  T* region = nullptr;
+  int regionBlocks = 0;
+  std::size_t regionBytes = 0;
+
+  // the j-th element of block b, honouring the block's rotation
+  T& at(int b, int j) const {
+    int k = offsets[b] + j;
+    if (k > b) k -= b + 1;
+    return blocks[b][k];
+  }
+
+  // element i by reference
+  T& ref(int i) const {
+    int b = i2b(i);
+    return at(b, i - (int)base(b));
+  }
+
+  template <typename... Args>
+  void construct(T* p, Args&&... args) {
+    Traits::construct(alloc, p, std::forward<Args>(args)...);
+  }
+
+  // block b holds b+1 slots
+  T* allocateBlock(int b) {
+    if (b < regionBlocks) return region + base(b);
+    return Traits::allocate(alloc, b + 1);
+  }
+  // region pages stay committed until trimRegion()
+  void freeBlock(T* block, int b) {
+    if (b < regionBlocks) return;
+    Traits::deallocate(alloc, block, b + 1);
+  }
+
+  // hand the region's pages past the attached blocks back to the kernel
+  void trimRegion() {
+    if (region == nullptr) return;
+    std::size_t used = std::size_t(base(std::min<int>(blocks.size(), regionBlocks))) * sizeof(T);
+    used = (used + hugePage - 1) & ~(hugePage - 1);
+    if (used < regionBytes) {
+      madvise(reinterpret_cast<char*>(region) + used, regionBytes - used, MADV_DONTNEED);
+    }
+  }
+
+  void unmapRegion() {
+    if (region == nullptr) return;
+    munmap(region, regionBytes);
+    region = nullptr;
+    regionBlocks = 0;
+    regionBytes = 0;
+  }
+
+  // shift elements [from, to) of block b one slot right (d = 1) or
+  // [from+1, to+1) one slot left (d = -1); all slots involved are live
+  void shiftInBlock(int b, int from, int to, int d) {
+    if (d > 0) {
+      for (int j = to; j > from; j--) at(b, j) = std::move(at(b, j - 1));
+    } else {
+      for (int j = from; j < to; j++) at(b, j) = std::move(at(b, j + 1));
+    }
+  }
+
+  // insert below the last element (n already counts it)
+  void tieredAdd(int i, T&& x) {
+    int b = i2b(i);
+    int j = i - (int)base(b);
+    int last = i2b(n - 1);           // block of the new last element
+    if (b == last) {
+      int cnt = n - 1 - (int)base(b);   // elements in b before the insert
+      construct(&at(b, cnt), std::move(at(b, cnt - 1)));
+      shiftInBlock(b, j, cnt - 1, 1);
+      at(b, j) = std::move(x);
+      return;
+    }
+    // b is full: its last element carries into the front of b+1, and so on;
+    // rotating a full block brings its last slot round to the front
+    T carry = std::move(at(b, b));
+    shiftInBlock(b, j, b, 1);
+    at(b, j) = std::move(x);
+    for (int k = b + 1; k <= last; k++) {
+      offsets[k] = offsets[k] == 0 ? k : offsets[k] - 1;
+      if (k < last) {
+        std::swap(carry, at(k, 0));
+      } else {
+        construct(&at(k, 0), std::move(carry));   // the last block's free slot
+      }
+    }
+  }
+
+  T tieredRemove(int i) {
+    int b = i2b(i);
+    int j = i - (int)base(b);
+    int last = i2b(n - 1);
+    T x = std::move(at(b, j));
+    if (b == last) {
+      int cnt = n - (int)base(b);
+      shiftInBlock(b, j, cnt - 1, -1);
+      at(b, cnt - 1).~T();
+      return x;
+    }
+    // close the gap in b, then pull the front of each later block back
+    shiftInBlock(b, j, b, -1);
+    for (int k = b + 1; k <= last; k++) {
+      at(k - 1, k - 1) = std::move(at(k, 0));
+      if (k == last) at(k, 0).~T();
+      offsets[k] = offsets[k] == k ? 0 : offsets[k] + 1;
+    }
+    return x;
+  }
+
+  // the element-by-element versions
+  void shiftAdd(int i, T&& x) {
+    construct(&ref(n - 1), std::move(ref(n - 2)));
+    for (int j = n - 2; j > i; j--) {
+      ref(j) = std::move(ref(j - 1));
+    }
+    ref(i) = std::move(x);
+  }
+
+  T shiftRemove(int i) {
+    T x = std::move(ref(i));
+    for (int j = i; j < n - 1; j++) {
+      ref(j) = std::move(ref(j + 1));
+    }
+    ref(n - 1).~T();
+    return x;
   }
 
   void grow() {
-    int new_size = blocks.size() + 1;
-    blocks.push_back(new T[new_size]);
+    int b = blocks.size();
+    if (!spare.empty()) {
+      blocks.push_back(spare.back());
+      spare.pop_back();
+    } else {
+      blocks.push_back(allocateBlock(b));
+      allocations++;
+    }
+    offsets.push_back(0);
+  }
+
+  // spare[k] is the block for index blocks.size() + spare.size() - 1 - k
+  void dropOldestSpare() {
+    freeBlock(spare.front(), blocks.size() + spare.size() - 1);
+    spare.erase(spare.begin());
+  }
+
+  // detach the last (empty) block, parking it in spare if there is room
+  void release() {
+    if (spareLimit > 0 && (int)spare.size() == spareLimit) {
+      // drop the largest parked block, it is the furthest from being needed
+      dropOldestSpare();
+    }
+    T* block = blocks.back();
+    blocks.pop_back();
+    offsets.pop_back();
+    if (spareLimit == 0) {
+      freeBlock(block, blocks.size());
+      return;
+    }
+    spare.push_back(block);
+  }
+
+  void freeSpare() {
+    while (!spare.empty()) {
+      dropOldestSpare();
+    }
   }
 
   void shrink() {
     int r = blocks.size();
-    while (r > 0 && (r - 2)*(r - 1)/2 >= n) {
-      delete [] blocks[r-1];
-      blocks.pop_back();
+    while (r > minBlocks && base(std::max(0, r - 1 - slack)) >= n) {
+      release();
       r--;
     }
   }
+
+  template<bool Const>
+  class Iter {
+  private:
+    friend class RootishArray;
+    friend class Iter<!Const>;
+    using ListPtr = typename std::conditional<Const, const RootishArray*, RootishArray*>::type;
+
+    // the block and offset are kept alongside the index so stepping
+    // never goes back through i2b
+    ListPtr list;
+    int i;
+    int b;
+    int j;
+
+    Iter(ListPtr owner, int index) : list(owner), i(index) {
+      b = i2b(i);
+      j = i - (int)base(b);
+    }
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<Const, const T*, T*>::type;
+    using reference = typename std::conditional<Const, const T&, T&>::type;
+
+    Iter() : list(nullptr), i(0), b(0), j(0) {}
+
+    // iterator -> const_iterator
+    template<bool C = Const, typename = typename std::enable_if<C>::type>
+    Iter(const Iter<false>& other) : list(other.list), i(other.i), b(other.b), j(other.j) {}
+
+    reference operator*() const { return list->at(b, j); }
+    pointer operator->() const { return &list->at(b, j); }
+    reference operator[](difference_type k) const { return *(*this + k); }
+
+    Iter& operator++() {
+      ++i;
+      if (++j > b) {
+        ++b;
+        j = 0;
+      }
+      return *this;
+    }
+
+    Iter operator++(int) {
+      Iter old = *this;
+      ++*this;
+      return old;
+    }
+
+    Iter& operator--() {
+      --i;
+      if (j == 0) {
+        --b;
+        j = b;
+      } else {
+        --j;
+      }
+      return *this;
+    }
+
+    Iter operator--(int) {
+      Iter old = *this;
+      --*this;
+      return old;
+    }
+
+    Iter& operator+=(difference_type k) {
+      i += (int)k;
+      j += (int)k;
+      if (j < 0 || j > b) {
+        b = i2b(i);
+        j = i - (int)base(b);
+      }
+      return *this;
+    }
+    Iter& operator-=(difference_type k) { return *this += -k; }
+
+    Iter operator+(difference_type k) const { Iter r = *this; return r += k; }
+    Iter operator-(difference_type k) const { Iter r = *this; return r += -k; }
+    friend Iter operator+(difference_type k, const Iter& it) { return it + k; }
+    difference_type operator-(const Iter& other) const { return i - other.i; }
+
+    bool operator==(const Iter& other) const { return i == other.i; }
+    bool operator!=(const Iter& other) const { return i != other.i; }
+    bool operator<(const Iter& other) const { return i < other.i; }
+    bool operator>(const Iter& other) const { return i > other.i; }
+    bool operator<=(const Iter& other) const { return i <= other.i; }
+    bool operator>=(const Iter& other) const { return i >= other.i; }
+  };
   
 public:
-  RootishArray() : n(0) {}
+  // index of the first element of block b (blocks 0..b-1 hold this many)
+  static long long base(int b) {
+    return (long long)b * (b + 1) / 2;
+  }
+
+  // block holding index i: the largest b with base(b) <= i, which is
+  // (isqrt(8i+1) - 1) / 2.  8i+1 < 2^34 is exact in a double and sqrt is
+  // correctly rounded, so truncating it is the exact integer root (sqrt of
+  // k*k-1 is k - 1/2k, far more than an ulp below k); no ceil, no branch.
+  static int i2b(int i) {
+    int r = (int)std::sqrt((double)(8LL * i + 1));
+    return (r - 1) >> 1;
+  }
+
+  using iterator = Iter<false>;
+  using const_iterator = Iter<true>;
+
+  RootishArray(const Alloc& alloc = Alloc())
+    : alloc(alloc), blocks(Rebind<T*>(alloc)), offsets(Rebind<int>(alloc)), n(0),
+      spare(Rebind<T*>(alloc)) {}
+
+  Alloc get_allocator() const {
+    return alloc;
+  }
 
   ~RootishArray() {
     clear();
+    unmapRegion();
+  }
+
+  // Place the blocks for the first maxElements elements in one reserved
+  // mapping advised MADV_HUGEPAGE (pages are committed as they are
+  // touched).  Only while the array is empty; returns false and keeps
+  // using Alloc if the mapping fails.  Without THP the region still works,
+  // on 4 KB pages.
+  bool mapRegion(int maxElements) {
+    if (n != 0) {
+      throw std::logic_error("mapRegion needs an empty array");
+    }
+    clear();
+    unmapRegion();
+    if (maxElements <= 0) return true;
+    int r = i2b(maxElements - 1) + 1;
+    std::size_t len = std::size_t(base(r)) * sizeof(T);
+    len = (len + hugePage - 1) & ~(hugePage - 1);
+    // map one huge page extra and trim, so the region starts 2 MB aligned
+    void* raw = mmap(nullptr, len + hugePage, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED) return false;
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+    std::uintptr_t aligned = (start + hugePage - 1) & ~(hugePage - 1);
+    if (aligned > start) munmap(raw, aligned - start);
+    munmap(reinterpret_cast<void*>(aligned + len), start + hugePage - aligned);
+    madvise(reinterpret_cast<void*>(aligned), len, MADV_HUGEPAGE);   // EINVAL without THP
+    region = reinterpret_cast<T*>(aligned);
+    regionBlocks = r;
+    regionBytes = len;
+    return true;
+  }
+
+  bool hasRegion() const {
+    return region != nullptr;
   }
 
   void clear() {
-    for (T* block : blocks) {
-      delete [] block;
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+      for (int i = 0; i < n; i++) ref(i).~T();
+    }
+    freeSpare();
+    for (int b = 0; b < (int)blocks.size(); b++) {
+      freeBlock(blocks[b], b);
     }
     blocks.clear();
+    offsets.clear();
+    minBlocks = 0;
     n=0;
+    trimRegion();
+  }
+
+  // number of elements the attached blocks can hold
+  int capacity() const {
+    return (int)base(blocks.size());
+  }
+
+  // keep capacity for at least cap elements until shrink_to_fit()
+  void reserve(int cap) {
+    int r = cap > 0 ? i2b(cap - 1) + 1 : 0;
+    minBlocks = std::max(minBlocks, r);
+    while ((int)blocks.size() < minBlocks) {
+      grow();
+    }
+  }
+
+  // drop the reserve, the spare blocks and every empty block
+  void shrink_to_fit() {
+    minBlocks = 0;
+    freeSpare();
+    while (!blocks.empty() && base(blocks.size() - 1) >= n) {
+      freeBlock(blocks.back(), blocks.size() - 1);
+      blocks.pop_back();
+      offsets.pop_back();
+    }
+    trimRegion();
+  }
+
+  // empty blocks kept attached before shrinking (default 1)
+  void setHysteresis(int blocks) {
+    slack = std::max(0, blocks);
+    shrink();
+  }
+
+  // released blocks kept for reuse instead of deleted (default 2)
+  void setSpareBlocks(int k) {
+    spareLimit = std::max(0, k);
+    while ((int)spare.size() > spareLimit) {
+      dropOldestSpare();
+    }
+  }
+
+  long long blockAllocations() const {
+    return allocations;
+  }
+
+  // O(sqrt n) insert/remove; can be switched at any time
+  void setTiered(bool on) {
+    tiered = on;
+  }
+  bool isTiered() const {
+    return tiered;
   }
 
   int size() const {
     return n;
   }
 
+  // random-access iterators; invalidated by add/remove
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, n); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, n); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
   bool empty() const {
     return n == 0;
   }
@@ -57,8 +471,8 @@ public:
       throw std::out_of_range("Index out of bounds");
     }
     int b = i2b(i);
-    int j = i - b * (b + 1) / 2;
-    return blocks[b][j];
+    int j = i - (int)base(b);
+    return at(b, j);
   }
 
   T set(int i , T x) { 
@@ -66,26 +480,56 @@ public:
       throw std::out_of_range("Index out of bounds");
     }
     int b = i2b(i);
-    int j = i - b * (b + 1) / 2;
-    T oldval = blocks[b][j];
-    blocks[b][j] = x;
+    int j = i - (int)base(b);
+    T oldval = std::move(at(b, j));
+    at(b, j) = std::move(x);
     return oldval;
   }
 
+  // construct an element in place at index i
+  template <typename... Args>
+  T& emplace(int i, Args&&... args) {
+    if (i < 0 || i > n) {
+      throw std::out_of_range("Index out of bounds");
+    }
+    if (i < n) {
+      add(i, T(std::forward<Args>(args)...));
+      return ref(i);
+    }
+    // blocks never move, so args may still refer into the array here
+    if (base(blocks.size()) < n + 1) {
+      grow();
+    }
+    T& slot = ref(n);
+    construct(&slot, std::forward<Args>(args)...);
+    n++;
+    return slot;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    return emplace(n, std::forward<Args>(args)...);
+  }
+
   void add(int i, T x) {
     if (i < 0 || i > n) {
       throw std::out_of_range("Index out of bounds"); 
   }
+    if (i == n) {
+      emplace(n, std::move(x));
+      return;
+    }
     int r = blocks.size();
-    if (r * (r + 1)/ 2 < n + 1) {
+    if (base(r) < n + 1) {
       grow();
     }
 
     n++;
-    for(int j = n - 1; j > i ; j--) {
-      set(j, get(j -1));
+    if (tiered) {
+      tieredAdd(i, std::move(x));
+    } else {
+      shiftAdd(i, std::move(x));
     }
-    set(i, x);
   }
 
   T remove(int i) {
@@ -93,21 +537,14 @@ public:
       throw std::out_of_range("Index out of bounds");
     } 
 
-    T x = get(i);
-    for(int j = i; j < n-1; j++) {
-      set(j, get(j + 1));
-    }
+    T x = tiered ? tieredRemove(i) : shiftRemove(i);
     n--;
-    
-    int r = blocks.size();
-    if ((r-2) * (r-1)/2 >= n) {
-      shrink();
-    }
+    shrink();
     return x;
   }
 
   void push_back( T x) {
-    add(n, x);
+    emplace(n, std::move(x));
   }
 
 
@@ -130,7 +567,7 @@ public:
             
             for (int j = 0; j < b + 1; j++) {
                 if (element_idx < n) {
-                    std::cout << blocks[b][j];
+                    std::cout << at(b, j);
                     element_idx++;
                 } else {
                     std::cout << "_";
@@ -150,6 +587,94 @@ public:
     }
 };
 
+// The previous floating-point mapping, kept for the benchmark: 8*i
+// overflows int past about 268M elements and ceil() of an inexact sqrt
+// can land one block off
+int doubleI2b(int i) {
+  double db = (-3.0 + sqrt(9+8*i)) / 2.0;
+  return (int)ceil(db);
+}
+
+// get() throughput at random indices and full-scan throughput via get(i)
+// and via the iterator, next to the old i2b on the same random indices
+void accessBenchmark(int n) {
+  RootishArray<int> a;
+  for (int i = 0; i < n; i++) a.push_back(i);
+  std::mt19937 rng(1);
+  std::vector<int> idx(1 << 22);
+  for (int& x : idx) x = rng() % n;
+  auto time = [](auto&& body) {
+    auto t0 = std::chrono::steady_clock::now();
+    long long s = body();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return std::make_pair(ns, s);
+  };
+  auto oldMap = time([&] { long long s = 0; for (int i : idx) s += doubleI2b(i); return s; });
+  auto newMap = time([&] { long long s = 0; for (int i : idx) s += RootishArray<int>::i2b(i); return s; });
+  auto randGet = time([&] { long long s = 0; for (int i : idx) s += a.get(i); return s; });
+  auto scanGet = time([&] { long long s = 0; for (int i = 0; i < n; i++) s += a.get(i); return s; });
+  auto scanIter = time([&] { long long s = 0; for (int x : a) s += x; return s; });
+  std::cout << "n=" << n << "\n"
+            << "  old double i2b   " << oldMap.first / idx.size() << " ns/index\n"
+            << "  exact i2b        " << newMap.first / idx.size() << " ns/index\n"
+            << "  random get       " << randGet.first / idx.size() << " ns/op\n"
+            << "  scan via get(i)  " << scanGet.first / n << " ns/elem\n"
+            << "  scan via iter    " << scanIter.first / n << " ns/elem"
+            << "  (" << ((oldMap.second ^ newMap.second ^ randGet.second ^ scanGet.second ^ scanIter.second) & 1) << ")\n";
+}
+
+// Random get() over n ints, blocks from the allocator or from a huge-page
+// region; the indices come from an LCG so the loop measures memory
+void regionBenchmark(bool region, int n, int ops) {
+  RootishArray<int> a;
+  if (region && !a.mapRegion(n)) {
+    std::cout << "  (mmap failed, blocks come from the allocator)\n";
+  }
+  for (int i = 0; i < n; i++) a.push_back(i);
+  std::uint32_t x = 1;
+  long long s = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < ops; k++) {
+    x = x * 1664525u + 1013904223u;
+    s += a.get(int(x % std::uint32_t(n)));
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  std::cout << "  " << (a.hasRegion() ? "huge-page region " : "allocator blocks ")
+            << ns / ops << " ns/op  (" << (s & 1) << ")\n";
+}
+
+// Tail push/pop bursts straddling a block boundary: block allocations and
+// time per operation for a given hysteresis and spare-block setting
+void oscillate(int hysteresis, int spareBlocks, int burst, int cycles) {
+  RootishArray<int> a;
+  a.setHysteresis(hysteresis);
+  a.setSpareBlocks(spareBlocks);
+  int start = (int)RootishArray<int>::base(500) - burst / 2;
+  for (int i = 0; i < start; i++) a.push_back(i);
+  long long before = a.blockAllocations();
+  auto t0 = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; c++) {
+    for (int k = 0; k < burst; k++) a.push_back(k);
+    for (int k = 0; k < burst; k++) a.pop_back();
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  std::cout << "  hysteresis " << hysteresis << ", spare " << spareBlocks
+            << ": " << a.blockAllocations() - before << " block allocations, "
+            << ns / (2.0 * burst * cycles) << " ns/op, capacity " << a.capacity() << "\n";
+}
+
+// Time mid-array inserts followed by the same number of removes
+double midInsertRemove(bool tiered, int n, int ops) {
+  RootishArray<int> a;
+  a.setTiered(tiered);
+  for (int i = 0; i < n; i++) a.push_back(i);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < ops; k++) a.add((n + k) / 2, -k);
+  for (int k = 0; k < ops; k++) a.remove(n / 3);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / (2.0 * ops);
+}
+
 // Example usage and testing
 int main() {
     RootishArray<int> stack;
@@ -173,6 +698,77 @@ int main() {
     int removed = stack.remove(5);
     std::cout << "Removed element: " << removed << std::endl;
     stack.printStructure();
+
+    // Elements are constructed in place and only live ones exist
+    RootishArray<std::string> words;
+    words.emplace_back(3, 'x');
+    words.emplace_back("rootish");
+    words.emplace(1, "array");
+    std::cout << "Strings: ";
+    for (const std::string& w : words) {
+        std::cout << w << ' ';
+    }
+    std::cout << "\n";
+
+    // A request-scoped array: blocks, block index and strings all come
+    // from one monotonic arena, released in one go at scope exit
+    {
+        std::pmr::monotonic_buffer_resource arena(1 << 16);
+        RootishArray<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> names(&arena);
+        for (int i = 0; i < 100; i++) {
+            names.emplace_back("a name long enough to need its own buffer");
+        }
+        std::cout << "Arena-backed strings: " << names.size() << ", all in the arena: "
+                  << std::boolalpha << (names.begin()[99].get_allocator().resource() == &arena)
+                  << "\n\n";
+    }
+
+    // Same operations in tiered-vector mode: blocks rotate instead of
+    // every later element moving
+    RootishArray<int> tiered;
+    tiered.setTiered(true);
+    for (int i = 0; i < 10; i++) {
+        tiered.push_back(i * 10);
+    }
+    tiered.add(3, 999);
+    tiered.remove(5);
+    std::cout << "Tiered mode after the same insert/remove:\n";
+    tiered.printStructure();
+
+    std::cout << "Iterator scan: ";
+    for (auto it = tiered.begin(); it != tiered.end(); ++it) {
+        std::cout << *it << ' ';
+    }
+    std::cout << "\nReverse via it[k]: ";
+    auto first = tiered.cbegin();
+    for (int k = tiered.size() - 1; k >= 0; k--) {
+        std::cout << first[k] << ' ';
+    }
+    std::cout << "\n\n";
+
+    accessBenchmark(1 << 22);
+
+    std::cout << "Random get over 2^26 ints:\n";
+    regionBenchmark(false, 1 << 26, 1 << 24);
+    regionBenchmark(true, 1 << 26, 1 << 24);
+
+    std::cout << "Tail push/pop bursts of 1200 around block 500:\n";
+    oscillate(1, 0, 1200, 2000);   // old behaviour
+    oscillate(1, 2, 1200, 2000);
+    oscillate(3, 0, 1200, 2000);
+
+    RootishArray<int> sized;
+    sized.reserve(1000);
+    for (int i = 0; i < 10; i++) sized.push_back(i);
+    std::cout << "reserve(1000) with 10 elements: capacity " << sized.capacity();
+    sized.shrink_to_fit();
+    std::cout << ", after shrink_to_fit: " << sized.capacity() << "\n\n";
+
+    std::cout << "Mid-array insert/remove, us per op:\n";
+    for (int n : {10000, 100000}) {
+        std::cout << "  n=" << n << "  shifting " << midInsertRemove(false, n, 200)
+                  << "  tiered " << midInsertRemove(true, n, 200) << "\n";
+    }
     
     return 0;
 }